@@ -1,243 +1,2408 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h> // Para tolower()
-
-// --- 1. DEFINIO DAS ESTRUTURAS ---
-
-#define HASH_SIZE 101
-
-typedef struct Sala {
-    char nome[50];
-    char pista[100];
-    struct Sala *esquerda;
-    struct Sala *direita;
-} Sala;
-
-typedef struct NoPista {
-    char pista[100];
-    struct NoPista *esquerda;
-    struct NoPista *direita;
-} NoPista;
-
-typedef struct HashItem {
-    char chave[100];
-    char valor[50];
-    struct HashItem *proximo;
-} HashItem;
-
-
-// --- 2. MDULO DA TABELA HASH ---
-
-HashItem* tabelaHash[HASH_SIZE];
-
-// ---- FUNES CORRIGIDAS ----
-unsigned int funcaoHash(const char *chave) {
-    unsigned long int hash = 0;
-    int c;
-    while ((c = *chave++)) {
-        hash = c + (hash << 6) + (hash << 16) - hash;
-    }
-    return hash % HASH_SIZE;
-}
-
-void inserirNaHash(const char *chave, const char *valor) {
-    HashItem *novoItem = (HashItem*) malloc(sizeof(HashItem));
-    strcpy(novoItem->chave, chave);
-    strcpy(novoItem->valor, valor);
-    novoItem->proximo = NULL;
-
-    unsigned int indice = funcaoHash(chave);
-    novoItem->proximo = tabelaHash[indice];
-    tabelaHash[indice] = novoItem;
-}
-
-char* encontrarSuspeito(const char *chave) {
-    unsigned int indice = funcaoHash(chave);
-    HashItem *item = tabelaHash[indice];
-    while (item != NULL) {
-        if (strcmp(item->chave, chave) == 0) {
-            return item->valor;
-        }
-        item = item->proximo;
-    }
-    return NULL;
-}
-
-
-// --- 3. MDULO DA RVORE DE PISTAS (BST) ---
-
-// ---- FUNO CORRIGIDA ----
-NoPista* inserirPista(NoPista* raiz, const char* pista) {
-    if (raiz == NULL) {
-        NoPista* novoNo = (NoPista*) malloc(sizeof(NoPista));
-        strcpy(novoNo->pista, pista);
-        novoNo->esquerda = novoNo->direita = NULL;
-        return novoNo;
-    }
-    int cmp = strcmp(pista, raiz->pista);
-    if (cmp < 0) {
-        raiz->esquerda = inserirPista(raiz->esquerda, pista);
-    } else if (cmp > 0) {
-        raiz->direita = inserirPista(raiz->direita, pista);
-    }
-    return raiz;
-}
-
-void mostrarPistas(NoPista* raiz) {
-    if (raiz != NULL) {
-        mostrarPistas(raiz->esquerda);
-        printf("- %s\n", raiz->pista);
-        mostrarPistas(raiz->direita);
-    }
-}
-
-
-// --- 4. MDULO DA MANSO (RVORE BINRIA) ---
-
-// ---- FUNO CORRIGIDA ----
-Sala* criarSala(const char* nome, const char* pista) {
-    Sala* novaSala = (Sala*) malloc(sizeof(Sala));
-    strcpy(novaSala->nome, nome);
-    strcpy(novaSala->pista, pista);
-    novaSala->esquerda = NULL;
-    novaSala->direita = NULL;
-    return novaSala;
-}
-
-void explorarSalas(Sala* salaInicial, NoPista** raizPistas) {
-    Sala* salaAtual = salaInicial;
-    char escolha;
-    printf("Voce esta no(a) %s. A mansao e vasta e escura...\n", salaAtual->nome);
-    while (salaAtual != NULL) {
-        if (strlen(salaAtual->pista) > 0) {
-            printf("Voce encontrou algo! Pista: [ %s ]\n", salaAtual->pista);
-            *raizPistas = inserirPista(*raizPistas, salaAtual->pista);
-            strcpy(salaAtual->pista, "");
-        }
-        printf("\nVoce esta no(a): %s\n", salaAtual->nome);
-        printf("Caminhos disponiveis:\n");
-        if (salaAtual->esquerda) printf("  (e)squerda -> %s\n", salaAtual->esquerda->nome);
-        if (salaAtual->direita) printf("  (d)ireita -> %s\n", salaAtual->direita->nome);
-        printf("  (s)air da exploracao e ir para o julgamento\n");
-        printf("Para onde voce vai? ");
-        scanf(" %c", &escolha);
-        escolha = tolower(escolha);
-        if (escolha == 'e' && salaAtual->esquerda != NULL) {
-            salaAtual = salaAtual->esquerda;
-        } else if (escolha == 'd' && salaAtual->direita != NULL) {
-            salaAtual = salaAtual->direita;
-        } else if (escolha == 's') {
-            printf("\nVoce sente que ja tem o suficiente. Hora de acusar o culpado.\n");
-            break;
-        } else {
-            printf("Caminho invalido. Tente novamente.\n");
-        }
-    }
-}
-
-int contarPistasParaSuspeito(NoPista* noPista, const char* suspeitoAcusado) {
-    if (noPista == NULL) return 0;
-    int contagem = 0;
-    char* suspeitoDaPista = encontrarSuspeito(noPista->pista);
-    if (suspeitoDaPista != NULL && strcmp(suspeitoDaPista, suspeitoAcusado) == 0) {
-        contagem = 1;
-    }
-    return contagem + contarPistasParaSuspeito(noPista->esquerda, suspeitoAcusado) + contarPistasParaSuspeito(noPista->direita, suspeitoAcusado);
-}
-
-void verificarSuspeitoFinal(NoPista* raizPistas) {
-    char acusado[50];
-    printf("\n--- O JULGAMENTO ---\n");
-    if (raizPistas == NULL) {
-        printf("Voce nao coletou nenhuma pista. O caso permanece um misterio.\n");
-        return;
-    }
-    printf("Pistas que voce coletou:\n");
-    mostrarPistas(raizPistas);
-    printf("\nSuspeitos: Mordomo, Jardineiro, Governanta, Dama_de_Companhia\n");
-    printf("Com base nas evidencias, quem voce acusa? ");
-    scanf("%49s", acusado); // Limita a entrada para evitar overflow
-    int numPistas = contarPistasParaSuspeito(raizPistas, acusado);
-    printf("\nAnalisando as evidencias contra %s...\n", acusado);
-    printf("Numero de pistas encontradas: %d\n", numPistas);
-    if (numPistas >= 2) {
-        printf("\nVEREDITO: CULPADO! As provas sao contundentes. Voce solucionou o caso!\n");
-    } else {
-        printf("\nVEREDITO: INOCENTE! Voce acusou a pessoa errada. O verdadeiro culpado escapou...\n");
-    }
-}
-
-// --- 5. FUNES PARA LIBERAR MEMRIA (MELHORIA) ---
-
-void liberarTabelaHash() {
-    for (int i = 0; i < HASH_SIZE; i++) {
-        HashItem *item = tabelaHash[i];
-        while (item != NULL) {
-            HashItem *temp = item;
-            item = item->proximo;
-            free(temp);
-        }
-        tabelaHash[i] = NULL;
-    }
-}
-
-void liberarArvorePistas(NoPista* raiz) {
-    if (raiz == NULL) return;
-    liberarArvorePistas(raiz->esquerda);
-    liberarArvorePistas(raiz->direita);
-    free(raiz);
-}
-
-void liberarArvoreSalas(Sala* raiz) {
-    if (raiz == NULL) return;
-    liberarArvoreSalas(raiz->esquerda);
-    liberarArvoreSalas(raiz->direita);
-    free(raiz);
-}
-
-
-// --- 6. LGICA PRINCIPAL DO JOGO ---
-
-int main() {
-    for (int i = 0; i < HASH_SIZE; i++) {
-        tabelaHash[i] = NULL;
-    }
-
-    // Montando o mapa da manso
-    Sala* raiz = criarSala("Hall de Entrada", "");
-    raiz->esquerda = criarSala("Biblioteca", "Um livro sobre venenos estava fora do lugar.");
-    raiz->direita = criarSala("Sala de Jantar", "Um frasco quebrado com um liquido suspeito.");
-    raiz->esquerda->esquerda = criarSala("Escritorio", "Uma carta de ameaca enderecada a vitima.");
-    raiz->esquerda->direita = criarSala("Jardim de Inverno", "Pegadas de botas sujas de terra.");
-    raiz->direita->direita = criarSala("Cozinha", "Uma faca afiada desapareceu do conjunto.");
-    raiz->direita->direita->esquerda = criarSala("Despensa", "Um recibo de compra de luvas de couro.");
-
-    // Associando Pistas a Suspeitos
-    inserirNaHash("Um livro sobre venenos estava fora do lugar.", "Governanta");
-    inserirNaHash("Um frasco quebrado com um liquido suspeito.", "Dama_de_Companhia");
-    inserirNaHash("Uma carta de ameaca enderecada a vitima.", "Jardineiro");
-    inserirNaHash("Pegadas de botas sujas de terra.", "Jardineiro");
-    inserirNaHash("Uma faca afiada desapareceu do conjunto.", "Mordomo");
-    inserirNaHash("Um recibo de compra de luvas de couro.", "Mordomo");
-
-    // Incio do Jogo
-    NoPista* arvoreDePistas = NULL;
-
-    printf("*****************************************\n");
-    printf("* DETECTIVE QUEST: O CASO FINAL         *\n");
-    printf("*****************************************\n");
-    printf("Explore os comodos, colete pistas e descubra o culpado.\n\n");
-
-    explorarSalas(raiz, &arvoreDePistas);
-    verificarSuspeitoFinal(arvoreDePistas);
-
-    // --- LIBERANDO TODA A MEMRIA ALOCADA ---
-    printf("\nLimpando a cena do crime (liberando memoria)...\n");
-    liberarTabelaHash();
-    liberarArvorePistas(arvoreDePistas);
-    liberarArvoreSalas(raiz);
-    printf("Sistema finalizado.\n");
-
-    return 0;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h> // Para tolower()
+#include <math.h> // exp() no benchmark da função hash
+#include <stdint.h> // Campos de tamanho fixo do mapa compilado
+#include <stdarg.h> // Relatórios do modo automático e erros de carga
+#include <chrono>  // Cronômetro monotônico dos benchmarks
+#include <algorithm>
+#include <atomic>
+#include <filesystem> // Lista os casos de um diretório
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>   // Pico de memória no benchmark
+#else
+#include <sys/resource.h>
+#include <sys/mman.h> // Mapa compilado mapeado em memória
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "Tela.h" // Quadros da exploração escritos de uma vez
+
+// --- 1. DEFINIÇÃO DAS ESTRUTURAS ---
+
+// Identificador de uma string internada (índice em TabelaStrings::textos).
+// O id 0 é reservado para "nenhuma" (sala sem pista, suspeito desconhecido).
+typedef unsigned int IdTexto;
+#define SEM_TEXTO 0
+
+// Sala da mansão. O índice da sala em Mansao::salas é o id do seu nome em
+// Mansao::nomes, então 0 (SEM_TEXTO) também serve para "sem caminho".
+// O registro tem tamanho fixo e é gravado assim mesmo no mapa compilado.
+typedef struct Sala {
+    IdTexto pista;          // SEM_TEXTO se a sala não tem pista
+    unsigned int esquerda;
+    unsigned int direita;
+} Sala;
+
+// Nó da árvore AVL de pistas. 'altura' é a altura da subárvore (folha = 1).
+typedef struct NoPista {
+    IdTexto pista;
+    int altura;
+    struct NoPista *esquerda;
+    struct NoPista *direita;
+} NoPista;
+
+// Entrada do índice hash de uma TabelaStrings (endereçamento aberto, Robin Hood).
+// A chave não é guardada: ela é o texto do próprio id.
+typedef struct HashItem {
+    unsigned int hash;
+    unsigned int distancia; // 0 = posição livre; senão, distância da posição ideal + 1
+    IdTexto id;
+} HashItem;
+
+// Bloco de memória da arena; os dados vêm logo depois do cabeçalho.
+typedef struct BlocoArena {
+    struct BlocoArena *anterior;
+    size_t tamanho;
+    size_t usado;
+} BlocoArena;
+
+// Arena de uma partida: salas, nós de pistas, entradas e textos da tabela hash
+// são tirados daqui e devolvidos todos de uma vez.
+typedef struct Arena {
+    BlocoArena *atual;
+    size_t proximoBloco;     // tamanho do próximo bloco (dobra a cada bloco novo)
+    int avulsa;              // 1 = cada pedido vira um malloc próprio (só para comparação)
+    void **avulsos;          // ponteiros do modo avulso, para liberar no fim
+    size_t numAvulsos, capAvulsos;
+    size_t numPedidos;       // chamadas a arenaAlocar
+    size_t numMallocs;       // chamadas a malloc feitas pela arena
+    size_t bytesPedidos;
+} Arena;
+
+// Cada texto é guardado uma única vez; quem precisa dele guarda só o IdTexto.
+// Os textos ficam lado a lado em 'textos' e 'deslocamentos' diz onde cada id
+// começa, o que permite usar direto as tabelas de um mapa compilado mapeado em memória.
+typedef struct TabelaStrings {
+    HashItem *itens;        // índice texto -> id; NULL até a primeira busca por texto
+    unsigned int capacidade; // sempre potência de 2
+    unsigned int mascara;    // capacidade - 1
+    char *textos;
+    size_t usoTextos;
+    size_t capTextos;
+    unsigned int *deslocamentos; // id -> posição em 'textos'
+    unsigned int quantidade;     // ids em uso, contando o 0
+    unsigned int capDeslocamentos;
+    Arena *arena;
+} TabelaStrings;
+
+typedef struct Mansao {
+    TabelaStrings nomes;    // nomes das salas; o id do nome é o índice da sala
+    Sala *salas;            // salas[0] não é usada
+    unsigned int capSalas;
+    void *mapa;             // mapa compilado mapeado em memória (ou NULL)
+    size_t tamMapa;
+    // Índices de navegação, NULL até prepararNavegacao. As salas são numeradas na
+    // ordem de visita de uma busca em profundidade a partir da entrada (pré-ordem),
+    // então a subárvore de uma sala ocupa as posições [entrada, saida).
+    unsigned int *pai;          // 0 na entrada e nas salas inalcançáveis
+    unsigned int *profundidade; // passos desde a entrada
+    unsigned int *entrada;      // posição da sala na pré-ordem (NAO_ALCANCADA se não tem)
+    unsigned int *saida;
+    unsigned int *ordem;        // sala em cada posição da pré-ordem
+    unsigned int numAlcancadas;
+    unsigned int folhas;        // potência de 2 >= numAlcancadas
+    unsigned int *maisRasa;     // árvore de segmentos: posição de menor profundidade
+    // Decomposição por centroides (ver montarCentroides), indexada pela posição na
+    // pré-ordem. NULL até prepararPistaMaisProxima.
+    unsigned int niveis;              // floor(log2 numAlcancadas) + 1
+    unsigned int *paiCentroide;       // NAO_ALCANCADA no centroide da árvore inteira
+    unsigned int *nivelCentroide;     // 0 no centroide da árvore inteira
+    unsigned int *distanciaCentroide; // [p * niveis + k]: passos de p até o seu centroide de nível k
+    unsigned int *inicioPistas;       // por centroide, a faixa [inicio, fim) de pistaPerto
+    unsigned int *fimPistas;
+    unsigned int *pistaPerto;         // posições com pista no pedaço do centroide, da mais perto à mais longe
+    unsigned int *distanciaPista;     // passos de cada uma delas até o centroide
+} Mansao;
+
+// Um caso carregado: a mansão, os textos e a ligação pista -> suspeito.
+// Depois de prepararCaso ele só é lido, então várias partidas (inclusive em
+// threads diferentes) podem usar o mesmo caso sem nenhuma sincronização.
+typedef struct Caso {
+    Arena arena;
+    TabelaStrings pistas;
+    TabelaStrings suspeitos;
+    IdTexto *suspeitoDaPista;           // indexado pelo id da pista
+    unsigned int capSuspeitoDaPista;
+    Mansao mansao;
+    char *erro;             // se não for NULL, as falhas de carga vão para cá em vez
+    size_t tamErro;         // de stderr (o modo --lote as põe no relatório do caso)
+} Caso;
+
+// Estado de uma partida sobre um caso. Nada fica em variáveis globais nem no
+// caso, então cada thread pode conduzir partidas próprias sem sincronização.
+typedef struct Jogo {
+    const Caso *caso;
+    Arena arena;                        // nós da árvore de pistas e vetores abaixo
+    uint64_t *pistaColetada;            // um bit por sala: a pista dela já foi recolhida
+    unsigned int *pistaMaisRasa;        // árvore de segmentos sobre a pré-ordem (NULL sem navegação)
+    unsigned int *proximaPista;         // por centroide: primeira entrada de pistaPerto não recolhida
+    Caso *casoExclusivo;                // o caso, se só esta partida o usa; senão NULL
+    // Evidências por suspeito (ver registrarEvidencia)
+    int *evidenciasDoSuspeito;          // indexado pelo id do suspeito
+    IdTexto *rankingSuspeitos;
+    unsigned int *posicaoNoRanking;     // indexado pelo id do suspeito
+    unsigned int numNoRanking;          // suspeitos já no ranking
+    unsigned int capRanking;
+    unsigned int *inicioFaixa;          // indexado pela contagem
+    unsigned int capFaixas;
+} Jogo;
+
+
+// --- 2. MÓDULO DA ARENA ---
+
+#define ARENA_BLOCO_INICIAL (64 * 1024)
+#define ARENA_BLOCO_MAXIMO  (64 * 1024 * 1024)
+#define ARENA_ALINHAMENTO   16
+// Espaço do cabeçalho no início de cada bloco, arredondado para manter os dados alinhados.
+#define ARENA_CABECALHO     ((sizeof(BlocoArena) + ARENA_ALINHAMENTO - 1) & ~(size_t) (ARENA_ALINHAMENTO - 1))
+
+void inicializarArena(Arena *a, int avulsa) {
+    memset(a, 0, sizeof(*a));
+    a->proximoBloco = ARENA_BLOCO_INICIAL;
+    a->avulsa = avulsa;
+}
+
+void* arenaAlocar(Arena *a, size_t tamanho, size_t alinhamento) {
+    a->numPedidos++;
+    a->bytesPedidos += tamanho;
+    if (a->avulsa) {
+        if (a->numAvulsos == a->capAvulsos) {
+            a->capAvulsos = a->capAvulsos ? a->capAvulsos * 2 : 1024;
+            a->avulsos = (void**) realloc(a->avulsos, a->capAvulsos * sizeof(void*));
+        }
+        a->numMallocs++;
+        return a->avulsos[a->numAvulsos++] = malloc(tamanho);
+    }
+    BlocoArena *b = a->atual;
+    size_t inicio = 0;
+    if (b != NULL) {
+        inicio = (b->usado + alinhamento - 1) & ~(alinhamento - 1);
+    }
+    if (b == NULL || inicio + tamanho > b->tamanho) {
+        size_t tamBloco = a->proximoBloco;
+        while (tamBloco < tamanho + alinhamento) tamBloco *= 2;
+        if (a->proximoBloco < ARENA_BLOCO_MAXIMO) a->proximoBloco *= 2;
+        b = (BlocoArena*) malloc(ARENA_CABECALHO + tamBloco);
+        a->numMallocs++;
+        b->anterior = a->atual;
+        b->tamanho = tamBloco;
+        b->usado = 0;
+        a->atual = b;
+        inicio = 0;
+    }
+    b->usado = inicio + tamanho;
+    return (char*) b + ARENA_CABECALHO + inicio;
+}
+
+char* arenaCopiarTexto(Arena *a, const char *texto) {
+    size_t tam = strlen(texto) + 1;
+    char *copia = (char*) arenaAlocar(a, tam, 1);
+    memcpy(copia, texto, tam);
+    return copia;
+}
+
+// Devolve toda a memória da arena de uma vez; a arena pode ser reutilizada depois.
+void liberarArena(Arena *a) {
+    while (a->atual != NULL) {
+        BlocoArena *anterior = a->atual->anterior;
+        free(a->atual);
+        a->atual = anterior;
+    }
+    for (size_t i = 0; i < a->numAvulsos; i++) free(a->avulsos[i]);
+    free(a->avulsos);
+    inicializarArena(a, a->avulsa);
+}
+
+
+// --- 3. MÓDULO DA TABELA HASH E DAS STRINGS INTERNADAS ---
+
+// A capacidade é potência de 2 (a posição é hash & mascara) e a tabela dobra
+// quando passa de 7/8 de ocupação.
+#define HASH_CAPACIDADE_INICIAL 64
+#define HASH_CAPACIDADE_MAXIMA  0x80000000u
+#define HASH_CARGA_NUM 7
+#define HASH_CARGA_DEN 8
+
+// Constantes de mistura do wyhash.
+static const uint64_t SEGREDO_HASH[2] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull};
+
+// Multiplica 64 x 64 -> 128 bits e junta as duas metades com xor.
+static inline uint64_t misturarHash(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t) a * b;
+    return (uint64_t) r ^ (uint64_t) (r >> 64);
+#else
+    uint64_t ha = a >> 32, la = (uint32_t) a, hb = b >> 32, lb = (uint32_t) b;
+    uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+    uint64_t meio = (ll >> 32) + (uint32_t) hl + (uint32_t) lh;
+    uint64_t baixo = (meio << 32) | (uint32_t) ll;
+    uint64_t alto = hh + (hl >> 32) + (lh >> 32) + (meio >> 32);
+    return baixo ^ alto;
+#endif
+}
+
+static inline uint64_t ler64(const char *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t ler32(const char *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// Hash no estilo do wyhash: consome 16 bytes por passo com uma multiplicação de
+// 128 bits; textos de até 16 bytes são lidos em no máximo quatro leituras. Usa o
+// tamanho já conhecido em vez de procurar o '\0'. O valor depende da ordem dos
+// bytes da máquina, então não deve ser gravado em arquivo.
+uint64_t funcaoHash(const char *chave, size_t tamanho) {
+    const char *p = chave;
+    uint64_t semente = SEGREDO_HASH[0];
+    uint64_t a, b;
+    if (tamanho <= 16) {
+        if (tamanho >= 4) {
+            size_t meio = (tamanho >> 3) << 2;
+            a = (ler32(p) << 32) | ler32(p + meio);
+            b = (ler32(p + tamanho - 4) << 32) | ler32(p + tamanho - 4 - meio);
+        } else if (tamanho > 0) {
+            a = ((uint64_t) (unsigned char) p[0] << 16) | ((uint64_t) (unsigned char) p[tamanho >> 1] << 8)
+                | (unsigned char) p[tamanho - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t resto = tamanho;
+        while (resto > 16) {
+            semente = misturarHash(ler64(p) ^ SEGREDO_HASH[1], ler64(p + 8) ^ semente);
+            p += 16;
+            resto -= 16;
+        }
+        a = ler64(p + resto - 16);
+        b = ler64(p + resto - 8);
+    }
+    return misturarHash(SEGREDO_HASH[1] ^ tamanho, misturarHash(a ^ SEGREDO_HASH[1], b ^ semente));
+}
+
+static void* crescerNaArena(Arena *arena, void *antigo, size_t usados, size_t novos, size_t tamItem) {
+    void *novo = arenaAlocar(arena, novos * tamItem, ARENA_ALINHAMENTO);
+    if (usados > 0) memcpy(novo, antigo, usados * tamItem);
+    memset((char*) novo + usados * tamItem, 0, (novos - usados) * tamItem);
+    return novo;
+}
+
+const char* textoDoId(const TabelaStrings *t, IdTexto id) {
+    return t->textos + t->deslocamentos[id];
+}
+
+// Tamanho do texto sem o '\0', pela distância até o texto seguinte.
+static size_t tamanhoDoId(const TabelaStrings *t, IdTexto id) {
+    size_t fim = id + 1 < t->quantidade ? t->deslocamentos[id + 1] : t->usoTextos;
+    return fim - t->deslocamentos[id] - 1;
+}
+
+// Coloca uma entrada já montada no índice, deslocando as entradas "mais ricas"
+// (mais próximas da posição ideal) para manter as sequências curtas.
+static void posicionarItem(TabelaStrings *t, HashItem item) {
+    unsigned int pos = item.hash & t->mascara;
+    item.distancia = 1;
+    while (1) {
+        HashItem *atual = &t->itens[pos];
+        if (atual->distancia == 0) {
+            *atual = item;
+            return;
+        }
+        if (atual->distancia < item.distancia) {
+            HashItem temp = *atual;
+            *atual = item;
+            item = temp;
+        }
+        item.distancia++;
+        pos = (pos + 1) & t->mascara;
+    }
+}
+
+static void indexarId(TabelaStrings *t, IdTexto id, unsigned int hash) {
+    HashItem item;
+    item.hash = hash;
+    item.id = id;
+    item.distancia = 0;
+    posicionarItem(t, item);
+}
+
+// (Re)constrói o índice com a menor capacidade que comporte 'ids' textos.
+// O vetor antigo fica na arena até o fim da partida (no máximo ~1x o tamanho atual).
+static void construirIndice(TabelaStrings *t, unsigned int ids) {
+    unsigned int capacidade = t->capacidade ? t->capacidade : HASH_CAPACIDADE_INICIAL;
+    while ((unsigned long long) ids * HASH_CARGA_DEN > (unsigned long long) capacidade * HASH_CARGA_NUM
+           && capacidade < HASH_CAPACIDADE_MAXIMA) {
+        capacidade *= 2;
+    }
+    t->capacidade = capacidade;
+    t->mascara = capacidade - 1;
+    t->itens = (HashItem*) crescerNaArena(t->arena, NULL, 0, t->capacidade, sizeof(HashItem));
+    for (IdTexto id = 1; id < t->quantidade; id++) {
+        indexarId(t, id, (unsigned int) funcaoHash(textoDoId(t, id), tamanhoDoId(t, id)));
+    }
+}
+
+void inicializarTabelaStrings(TabelaStrings *t, Arena *arena) {
+    memset(t, 0, sizeof(*t));
+    t->arena = arena;
+    t->capTextos = 1024;
+    t->textos = (char*) arenaAlocar(arena, t->capTextos, 1);
+    t->textos[0] = '\0';
+    t->usoTextos = 1;
+    t->capDeslocamentos = 64;
+    t->deslocamentos = (unsigned int*) crescerNaArena(arena, NULL, 0, t->capDeslocamentos, sizeof(unsigned int));
+    t->quantidade = 1; // id 0 -> ""
+    construirIndice(t, 0);
+}
+
+// Usa textos e deslocamentos já prontos (por exemplo, de um mapa compilado) sem copiá-los.
+// O índice por texto só é montado se alguém buscar um texto nesta tabela.
+void adotarTabelaStrings(TabelaStrings *t, Arena *arena, char *textos, size_t tamTextos,
+                         unsigned int *deslocamentos, unsigned int quantidade) {
+    memset(t, 0, sizeof(*t));
+    t->arena = arena;
+    t->textos = textos;
+    t->usoTextos = t->capTextos = tamTextos;
+    t->deslocamentos = deslocamentos;
+    t->quantidade = t->capDeslocamentos = quantidade;
+}
+
+// Monta o índice por texto de uma tabela adotada (nas outras ele já existe).
+// Tabelas compartilhadas entre threads precisam dele antes de serem compartilhadas.
+void indexarTabela(TabelaStrings *t) {
+    if (t->itens == NULL) construirIndice(t, t->quantidade);
+}
+
+// Pela invariante Robin Hood, a busca pode parar assim que encontrar uma entrada
+// mais perto da posição ideal do que a chave estaria.
+static IdTexto buscarComHash(const TabelaStrings *t, const char *texto, unsigned int hash) {
+    unsigned int pos = hash & t->mascara;
+    unsigned int distancia = 1;
+    while (1) {
+        const HashItem *atual = &t->itens[pos];
+        if (atual->distancia < distancia) return SEM_TEXTO;
+        if (atual->hash == hash && strcmp(textoDoId(t, atual->id), texto) == 0) {
+            return atual->id;
+        }
+        distancia++;
+        pos = (pos + 1) & t->mascara;
+    }
+}
+
+// Devolve o id do texto ou SEM_TEXTO.
+// Não altera a tabela: numa tabela adotada ainda sem índice, procura texto por texto.
+IdTexto buscarIdTexto(const TabelaStrings *t, const char *texto) {
+    if (t->itens == NULL) {
+        for (IdTexto id = 1; id < t->quantidade; id++) {
+            if (strcmp(textoDoId(t, id), texto) == 0) return id;
+        }
+        return SEM_TEXTO;
+    }
+    return buscarComHash(t, texto, (unsigned int) funcaoHash(texto, strlen(texto)));
+}
+
+// Devolve o id do texto, guardando-o se ainda não existir. "" vira SEM_TEXTO.
+// Tabelas adotadas de um mapa são copiadas para a arena na primeira inserção.
+IdTexto internarTexto(TabelaStrings *t, const char *texto) {
+    if (texto[0] == '\0') return SEM_TEXTO;
+    indexarTabela(t);
+    size_t tam = strlen(texto) + 1;
+    unsigned int hash = (unsigned int) funcaoHash(texto, tam - 1);
+    IdTexto id = buscarComHash(t, texto, hash);
+    if (id != SEM_TEXTO) return id;
+
+    if (t->usoTextos + tam > t->capTextos) {
+        size_t nova = t->capTextos * 2;
+        while (t->usoTextos + tam > nova) nova *= 2;
+        t->textos = (char*) crescerNaArena(t->arena, t->textos, t->usoTextos, nova, 1);
+        t->capTextos = nova;
+    }
+    if (t->quantidade == t->capDeslocamentos) {
+        unsigned int nova = t->capDeslocamentos * 2;
+        t->deslocamentos = (unsigned int*) crescerNaArena(t->arena, t->deslocamentos, t->quantidade, nova, sizeof(unsigned int));
+        t->capDeslocamentos = nova;
+    }
+    id = t->quantidade++;
+    t->deslocamentos[id] = (unsigned int) t->usoTextos;
+    memcpy(t->textos + t->usoTextos, texto, tam);
+    t->usoTextos += tam;
+
+    if ((unsigned long long) t->quantidade * HASH_CARGA_DEN > (unsigned long long) t->capacidade * HASH_CARGA_NUM
+        && t->capacidade < HASH_CAPACIDADE_MAXIMA) {
+        construirIndice(t, t->quantidade);
+    } else {
+        indexarId(t, id, hash);
+    }
+    return id;
+}
+
+
+// --- 4. MÓDULO DAS PISTAS E SUSPEITOS ---
+
+void inicializarPistasESuspeitos(Caso *caso) {
+    Arena *arena = &caso->arena;
+    inicializarTabelaStrings(&caso->pistas, arena);
+    inicializarTabelaStrings(&caso->suspeitos, arena);
+    caso->capSuspeitoDaPista = caso->pistas.capDeslocamentos;
+    caso->suspeitoDaPista = (IdTexto*) crescerNaArena(arena, NULL, 0, caso->capSuspeitoDaPista, sizeof(IdTexto));
+}
+
+// Associa a pista ao suspeito. Se a pista já existir, a associação é substituída.
+void inserirNaHash(Caso *caso, const char *chave, const char *valor) {
+    IdTexto pista = internarTexto(&caso->pistas, chave);
+    if (pista >= caso->capSuspeitoDaPista) {
+        caso->suspeitoDaPista = (IdTexto*) crescerNaArena(caso->pistas.arena, caso->suspeitoDaPista, caso->capSuspeitoDaPista,
+                                                    caso->pistas.capDeslocamentos, sizeof(IdTexto));
+        caso->capSuspeitoDaPista = caso->pistas.capDeslocamentos;
+    }
+    caso->suspeitoDaPista[pista] = internarTexto(&caso->suspeitos, valor);
+}
+
+IdTexto suspeitoDoIdPista(const Caso *caso, IdTexto pista) {
+    return pista < caso->capSuspeitoDaPista ? caso->suspeitoDaPista[pista] : SEM_TEXTO;
+}
+
+const char* encontrarSuspeito(const Caso *caso, const char *chave) {
+    IdTexto suspeito = suspeitoDoIdPista(caso, buscarIdTexto(&caso->pistas, chave));
+    return suspeito == SEM_TEXTO ? NULL : textoDoId(&caso->suspeitos, suspeito);
+}
+
+// Contadores de evidências por suspeito, atualizados a cada pista coletada.
+// 'rankingSuspeitos' fica sempre ordenado por contagem decrescente: os suspeitos
+// com contagem c ocupam as posições [inicioFaixa[c], inicioFaixa[c-1]) (ou até o
+// fim do vetor, para c = 0). Subir um suspeito de c para c+1 é trocá-lo com o
+// primeiro da própria faixa e avançar inicioFaixa[c], em O(1).
+
+static void* crescerVetor(Jogo *jogo, void *antigo, size_t usados, size_t novos, size_t tamItem) {
+    return crescerNaArena(&jogo->arena, antigo, usados, novos, tamItem);
+}
+
+void inicializarEvidencias(Jogo *jogo) {
+    jogo->capRanking = 16;
+    jogo->capFaixas = 16;
+    jogo->numNoRanking = 0;
+    jogo->evidenciasDoSuspeito = (int*) crescerVetor(jogo, NULL, 0, jogo->capRanking, sizeof(int));
+    jogo->rankingSuspeitos = (IdTexto*) crescerVetor(jogo, NULL, 0, jogo->capRanking, sizeof(IdTexto));
+    jogo->posicaoNoRanking = (unsigned int*) crescerVetor(jogo, NULL, 0, jogo->capRanking, sizeof(unsigned int));
+    jogo->inicioFaixa = (unsigned int*) crescerVetor(jogo, NULL, 0, jogo->capFaixas, sizeof(unsigned int));
+}
+
+// Garante que todos os suspeitos já internados estejam no ranking (com 0 evidências,
+// entram no fim, que é a faixa da contagem 0).
+static void acompanharNovosSuspeitos(Jogo *jogo) {
+    if (jogo->caso->suspeitos.quantidade > jogo->capRanking) {
+        unsigned int nova = jogo->capRanking;
+        while (nova < jogo->caso->suspeitos.quantidade) nova *= 2;
+        jogo->evidenciasDoSuspeito = (int*) crescerVetor(jogo, jogo->evidenciasDoSuspeito, jogo->capRanking, nova, sizeof(int));
+        jogo->rankingSuspeitos = (IdTexto*) crescerVetor(jogo, jogo->rankingSuspeitos, jogo->capRanking, nova, sizeof(IdTexto));
+        jogo->posicaoNoRanking = (unsigned int*) crescerVetor(jogo, jogo->posicaoNoRanking, jogo->capRanking, nova, sizeof(unsigned int));
+        jogo->capRanking = nova;
+    }
+    // Os ids de suspeito vão de 1 a quantidade - 1 (o 0 é SEM_TEXTO).
+    while (jogo->numNoRanking + 1 < jogo->caso->suspeitos.quantidade) {
+        IdTexto novo = jogo->numNoRanking + 1;
+        jogo->rankingSuspeitos[jogo->numNoRanking] = novo;
+        jogo->posicaoNoRanking[novo] = jogo->numNoRanking;
+        jogo->numNoRanking++;
+    }
+}
+
+// Soma uma evidência ao suspeito ligado à pista (se houver).
+void registrarEvidencia(Jogo *jogo, IdTexto pista) {
+    IdTexto suspeito = suspeitoDoIdPista(jogo->caso, pista);
+    if (suspeito == SEM_TEXTO) return;
+    acompanharNovosSuspeitos(jogo);
+    unsigned int c = (unsigned int) jogo->evidenciasDoSuspeito[suspeito];
+    if (c + 2 > jogo->capFaixas) {
+        jogo->inicioFaixa = (unsigned int*) crescerVetor(jogo, jogo->inicioFaixa, jogo->capFaixas, jogo->capFaixas * 2, sizeof(unsigned int));
+        jogo->capFaixas *= 2;
+    }
+    unsigned int primeiro = jogo->inicioFaixa[c];
+    unsigned int atual = jogo->posicaoNoRanking[suspeito];
+    IdTexto outro = jogo->rankingSuspeitos[primeiro];
+    jogo->rankingSuspeitos[primeiro] = suspeito;
+    jogo->rankingSuspeitos[atual] = outro;
+    jogo->posicaoNoRanking[outro] = atual;
+    jogo->posicaoNoRanking[suspeito] = primeiro;
+    jogo->inicioFaixa[c]++;
+    jogo->evidenciasDoSuspeito[suspeito]++;
+}
+
+int evidenciasContra(Jogo *jogo, IdTexto suspeito) {
+    if (suspeito == SEM_TEXTO || suspeito >= jogo->capRanking) return 0;
+    return jogo->evidenciasDoSuspeito[suspeito];
+}
+
+// Copia até 'max' suspeitos, do mais para o menos incriminado. Devolve quantos copiou.
+int listarRankingSuspeitos(Jogo *jogo, IdTexto *destino, int max) {
+    acompanharNovosSuspeitos(jogo);
+    int total = (int) jogo->numNoRanking;
+    if (total > max) total = max;
+    memcpy(destino, jogo->rankingSuspeitos, total * sizeof(IdTexto));
+    return total;
+}
+
+
+// --- 5. MÓDULO DA ÁRVORE DE PISTAS (AVL) ---
+
+// A altura de uma AVL com 2^32 nós fica abaixo de 48, então uma pilha fixa basta
+// para inserção e percurso sem recursão.
+#define ALTURA_MAXIMA_PISTAS 64
+
+static int alturaPista(const NoPista* no) {
+    return no ? no->altura : 0;
+}
+
+static void atualizarAltura(NoPista* no) {
+    int he = alturaPista(no->esquerda), hd = alturaPista(no->direita);
+    no->altura = (he > hd ? he : hd) + 1;
+}
+
+static NoPista* rotacionarDireita(NoPista* no) {
+    NoPista* filho = no->esquerda;
+    no->esquerda = filho->direita;
+    filho->direita = no;
+    atualizarAltura(no);
+    atualizarAltura(filho);
+    return filho;
+}
+
+static NoPista* rotacionarEsquerda(NoPista* no) {
+    NoPista* filho = no->direita;
+    no->direita = filho->esquerda;
+    filho->esquerda = no;
+    atualizarAltura(no);
+    atualizarAltura(filho);
+    return filho;
+}
+
+static NoPista* rebalancear(NoPista* no) {
+    atualizarAltura(no);
+    int fator = alturaPista(no->esquerda) - alturaPista(no->direita);
+    if (fator > 1) {
+        if (alturaPista(no->esquerda->esquerda) < alturaPista(no->esquerda->direita)) {
+            no->esquerda = rotacionarEsquerda(no->esquerda);
+        }
+        return rotacionarDireita(no);
+    }
+    if (fator < -1) {
+        if (alturaPista(no->direita->direita) < alturaPista(no->direita->esquerda)) {
+            no->direita = rotacionarDireita(no->direita);
+        }
+        return rotacionarEsquerda(no);
+    }
+    return no;
+}
+
+// Ordem alfabética entre duas pistas; ids iguais dispensam comparar o texto.
+static int compararPistas(Jogo *jogo, IdTexto a, IdTexto b) {
+    if (a == b) return 0;
+    return strcmp(textoDoId(&jogo->caso->pistas, a), textoDoId(&jogo->caso->pistas, b));
+}
+
+// Inserção iterativa: desce guardando os ponteiros de ligação e depois sobe
+// rebalanceando. Pistas repetidas são ignoradas. Devolve a nova raiz; se
+// 'nova' não for NULL, recebe 1 quando a pista ainda não estava na árvore.
+NoPista* inserirPista(Jogo *jogo, NoPista* raiz, IdTexto pista, int *nova) {
+    NoPista** caminho[ALTURA_MAXIMA_PISTAS];
+    int profundidade = 0;
+    NoPista** ligacao = &raiz;
+    while (*ligacao != NULL) {
+        int cmp = compararPistas(jogo, pista, (*ligacao)->pista);
+        if (cmp == 0) {
+            if (nova) *nova = 0;
+            return raiz;
+        }
+        caminho[profundidade++] = ligacao;
+        ligacao = cmp < 0 ? &(*ligacao)->esquerda : &(*ligacao)->direita;
+    }
+    NoPista* novoNo = (NoPista*) arenaAlocar(&jogo->arena, sizeof(NoPista), ARENA_ALINHAMENTO);
+    novoNo->pista = pista;
+    novoNo->altura = 1;
+    novoNo->esquerda = novoNo->direita = NULL;
+    *ligacao = novoNo;
+    if (nova) *nova = 1;
+
+    while (profundidade > 0) {
+        NoPista** atual = caminho[--profundidade];
+        int alturaAntes = (*atual)->altura;
+        *atual = rebalancear(*atual);
+        if ((*atual)->altura == alturaAntes) break; // acima daqui nada muda
+    }
+    return raiz;
+}
+
+NoPista* buscarPista(Jogo *jogo, NoPista* raiz, IdTexto pista) {
+    while (raiz != NULL) {
+        int cmp = compararPistas(jogo, pista, raiz->pista);
+        if (cmp == 0) return raiz;
+        raiz = cmp < 0 ? raiz->esquerda : raiz->direita;
+    }
+    return NULL;
+}
+
+// Percurso em ordem (alfabética) sem recursão, chamando 'visitar' para cada nó.
+void percorrerPistas(NoPista* raiz, void (*visitar)(NoPista*, void*), void* contexto) {
+    NoPista* pilha[ALTURA_MAXIMA_PISTAS];
+    int topo = 0;
+    NoPista* atual = raiz;
+    while (atual != NULL || topo > 0) {
+        while (atual != NULL) {
+            pilha[topo++] = atual;
+            atual = atual->esquerda;
+        }
+        atual = pilha[--topo];
+        visitar(atual, contexto);
+        atual = atual->direita;
+    }
+}
+
+static void imprimirPista(NoPista* no, void* contexto) {
+    Jogo *jogo = (Jogo*) contexto;
+    printf("- %s\n", textoDoId(&jogo->caso->pistas, no->pista));
+}
+
+void mostrarPistas(Jogo *jogo, NoPista* raiz) {
+    percorrerPistas(raiz, imprimirPista, jogo);
+}
+
+
+// --- 6. MÓDULO DA MANSÃO (ÁRVORE BINÁRIA) ---
+
+#define SALA_INICIAL 1 // a primeira sala declarada no mapa
+
+void inicializarMansao(Caso *caso) {
+    Arena *arena = &caso->arena;
+    memset(&caso->mansao, 0, sizeof(caso->mansao));
+    inicializarTabelaStrings(&caso->mansao.nomes, arena);
+    caso->mansao.capSalas = caso->mansao.nomes.capDeslocamentos;
+    caso->mansao.salas = (Sala*) crescerNaArena(arena, NULL, 0, caso->mansao.capSalas, sizeof(Sala));
+}
+
+unsigned int numSalas(const Caso *caso) {
+    return caso->mansao.nomes.quantidade; // inclui a posição 0, que não é sala
+}
+
+const char* nomeDaSala(const Caso *caso, unsigned int sala) {
+    return textoDoId(&caso->mansao.nomes, sala);
+}
+
+// Devolve o índice da sala com esse nome, criando-a (sem pista nem caminhos) se preciso.
+unsigned int obterSala(Caso *caso, const char* nome) {
+    unsigned int sala = internarTexto(&caso->mansao.nomes, nome);
+    if (caso->mansao.nomes.quantidade > caso->mansao.capSalas) {
+        caso->mansao.salas = (Sala*) crescerNaArena(&caso->arena, caso->mansao.salas, caso->mansao.capSalas,
+                                                    caso->mansao.nomes.capDeslocamentos, sizeof(Sala));
+        caso->mansao.capSalas = caso->mansao.nomes.capDeslocamentos;
+    }
+    return sala;
+}
+
+// ---- FUNÇÃO CORRIGIDA ----
+unsigned int criarSala(Caso *caso, const char* nome, const char* pista) {
+    unsigned int sala = obterSala(caso, nome);
+    caso->mansao.salas[sala].pista = internarTexto(&caso->pistas, pista);
+    return sala;
+}
+
+// --- 7. MÓDULO DE NAVEGAÇÃO (ÍNDICES SOBRE A MANSÃO) ---
+
+#define NAO_ALCANCADA 0xFFFFFFFFu // sala fora da árvore, ou "nenhuma posição"
+
+// Das duas posições da pré-ordem, a da sala mais rasa (NAO_ALCANCADA perde sempre).
+static unsigned int maisRasaEntre(const Mansao *m, unsigned int a, unsigned int b) {
+    if (a == NAO_ALCANCADA) return b;
+    if (b == NAO_ALCANCADA) return a;
+    return m->profundidade[m->ordem[b]] < m->profundidade[m->ordem[a]] ? b : a;
+}
+
+// Posição da sala mais rasa em [inicio, fim), numa árvore de segmentos de 'folhas'
+// folhas (arvore[folhas + p] é a folha da posição p). O(log n).
+static unsigned int consultarMaisRasa(const Mansao *m, const unsigned int *arvore, unsigned int inicio, unsigned int fim) {
+    unsigned int melhor = NAO_ALCANCADA;
+    for (inicio += m->folhas, fim += m->folhas; inicio < fim; inicio /= 2, fim /= 2) {
+        if (inicio & 1) melhor = maisRasaEntre(m, melhor, arvore[inicio++]);
+        if (fim & 1) melhor = maisRasaEntre(m, melhor, arvore[--fim]);
+    }
+    return melhor;
+}
+
+// Preenche os nós internos a partir das folhas já preenchidas.
+static void montarMaisRasa(const Mansao *m, unsigned int *arvore) {
+    for (unsigned int no = m->folhas - 1; no >= 1; no--) {
+        arvore[no] = maisRasaEntre(m, arvore[2 * no], arvore[2 * no + 1]);
+    }
+}
+
+// Vizinhas da posição 'p' na árvore da navegação (a sala de cima e as de baixo),
+// também como posições da pré-ordem. Devolve quantas escreveu (até 3).
+static int vizinhasNaArvore(const Mansao *m, unsigned int p, unsigned int *vizinhas) {
+    unsigned int sala = m->ordem[p];
+    int n = 0;
+    if (sala != SALA_INICIAL) vizinhas[n++] = m->entrada[m->pai[sala]];
+    unsigned int filhos[2] = {m->salas[sala].esquerda, m->salas[sala].direita};
+    for (int i = 0; i < 2; i++) {
+        unsigned int filho = filhos[i];
+        if (i == 1 && filho == filhos[0]) break;
+        if (filho != SEM_TEXTO && filho < m->nomes.quantidade && m->entrada[filho] != NAO_ALCANCADA
+            && m->pai[filho] == sala) {
+            vizinhas[n++] = m->entrada[filho];
+        }
+    }
+    return n;
+}
+
+// Decomposição por centroides: o centroide de um pedaço da árvore é a sala cuja
+// retirada o deixa em partes de no máximo metade do tamanho, e cada parte é
+// decomposta de novo, um nível abaixo. O caminho entre duas salas passa sempre por
+// um centroide acima das duas, e cada sala tem no máximo 'niveis' centroides acima
+// de si. Cada centroide guarda as salas com pista do seu pedaço na ordem de uma
+// busca em largura a partir dele, ou seja, da mais perto à mais longe.
+// Tempo e memória O(n log n); pilha e filas explícitas, como na pré-ordem.
+static void montarCentroides(Caso *caso) {
+    Mansao *m = &caso->mansao;
+    unsigned int n = m->numAlcancadas;
+    m->niveis = 1;
+    while ((n >> m->niveis) != 0) m->niveis++;
+    m->paiCentroide = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, n, sizeof(unsigned int));
+    m->nivelCentroide = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, n, sizeof(unsigned int));
+    m->distanciaCentroide = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, (size_t) n * m->niveis, sizeof(unsigned int));
+    m->inicioPistas = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, n, sizeof(unsigned int));
+    m->fimPistas = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, n, sizeof(unsigned int));
+    memset(m->nivelCentroide, 0xFF, n * sizeof(unsigned int)); // NAO_ALCANCADA = ainda no pedaço
+
+    // As listas só têm tamanho conhecido no fim; crescem fora da arena e são copiadas.
+    size_t numPistas = 0, capPistas = n;
+    unsigned int *pistaPerto = (unsigned int*) malloc(capPistas * sizeof(unsigned int));
+    unsigned int *distanciaPista = (unsigned int*) malloc(capPistas * sizeof(unsigned int));
+    unsigned int *fila = (unsigned int*) malloc(n * sizeof(unsigned int));
+    unsigned int *anterior = (unsigned int*) malloc(n * sizeof(unsigned int));
+    unsigned int *tamanho = (unsigned int*) malloc(n * sizeof(unsigned int)); // depois, distância
+    struct Pedaco { unsigned int raiz, pai, nivel; } *pilha = (struct Pedaco*) malloc(n * sizeof(struct Pedaco));
+    int topo = 0;
+    pilha[topo].raiz = 0; pilha[topo].pai = NAO_ALCANCADA; pilha[topo].nivel = 0; topo++;
+    while (topo > 0) {
+        struct Pedaco pedaco = pilha[--topo];
+        unsigned int vizinhas[3];
+
+        // Tamanho das subárvores do pedaço, vistas a partir de 'raiz'.
+        unsigned int fim = 0;
+        fila[fim++] = pedaco.raiz;
+        anterior[pedaco.raiz] = NAO_ALCANCADA;
+        for (unsigned int i = 0; i < fim; i++) {
+            unsigned int p = fila[i];
+            tamanho[p] = 1;
+            int k = vizinhasNaArvore(m, p, vizinhas);
+            for (int j = 0; j < k; j++) {
+                if (vizinhas[j] != anterior[p] && m->nivelCentroide[vizinhas[j]] == NAO_ALCANCADA) {
+                    anterior[vizinhas[j]] = p;
+                    fila[fim++] = vizinhas[j];
+                }
+            }
+        }
+        for (unsigned int i = fim; i-- > 1;) tamanho[anterior[fila[i]]] += tamanho[fila[i]];
+
+        // Desce enquanto alguma subárvore tiver mais da metade do pedaço.
+        unsigned int centroide = pedaco.raiz;
+        for (int desceu = 1; desceu;) {
+            desceu = 0;
+            int k = vizinhasNaArvore(m, centroide, vizinhas);
+            for (int j = 0; j < k && !desceu; j++) {
+                unsigned int v = vizinhas[j];
+                if (v != anterior[centroide] && m->nivelCentroide[v] == NAO_ALCANCADA && tamanho[v] > fim / 2) {
+                    centroide = v;
+                    desceu = 1;
+                }
+            }
+        }
+        m->nivelCentroide[centroide] = pedaco.nivel;
+        m->paiCentroide[centroide] = pedaco.pai;
+
+        // Distâncias do centroide a todo o pedaço, e as pistas dele em ordem de distância.
+        m->inicioPistas[centroide] = (unsigned int) numPistas;
+        fim = 0;
+        fila[fim++] = centroide;
+        anterior[centroide] = NAO_ALCANCADA;
+        tamanho[centroide] = 0;
+        for (unsigned int i = 0; i < fim; i++) {
+            unsigned int p = fila[i];
+            m->distanciaCentroide[(size_t) p * m->niveis + pedaco.nivel] = tamanho[p];
+            if (m->salas[m->ordem[p]].pista != SEM_TEXTO) {
+                if (numPistas == capPistas) {
+                    capPistas *= 2;
+                    pistaPerto = (unsigned int*) realloc(pistaPerto, capPistas * sizeof(unsigned int));
+                    distanciaPista = (unsigned int*) realloc(distanciaPista, capPistas * sizeof(unsigned int));
+                }
+                pistaPerto[numPistas] = p;
+                distanciaPista[numPistas++] = tamanho[p];
+            }
+            int k = vizinhasNaArvore(m, p, vizinhas);
+            for (int j = 0; j < k; j++) {
+                if (vizinhas[j] != anterior[p] && m->nivelCentroide[vizinhas[j]] == NAO_ALCANCADA) {
+                    anterior[vizinhas[j]] = p;
+                    tamanho[vizinhas[j]] = tamanho[p] + 1;
+                    fila[fim++] = vizinhas[j];
+                }
+            }
+        }
+        m->fimPistas[centroide] = (unsigned int) numPistas;
+
+        // As partes que sobram viram pedaços do nível de baixo.
+        int k = vizinhasNaArvore(m, centroide, vizinhas);
+        for (int j = 0; j < k; j++) {
+            if (m->nivelCentroide[vizinhas[j]] == NAO_ALCANCADA) {
+                pilha[topo].raiz = vizinhas[j]; pilha[topo].pai = centroide; pilha[topo].nivel = pedaco.nivel + 1; topo++;
+            }
+        }
+    }
+    size_t copiar = numPistas > 0 ? numPistas : 1;
+    m->pistaPerto = (unsigned int*) crescerNaArena(&caso->arena, pistaPerto, numPistas, copiar, sizeof(unsigned int));
+    m->distanciaPista = (unsigned int*) crescerNaArena(&caso->arena, distanciaPista, numPistas, copiar, sizeof(unsigned int));
+    free(pilha);
+    free(tamanho);
+    free(anterior);
+    free(fila);
+    free(distanciaPista);
+    free(pistaPerto);
+}
+
+// Monta o índice de nomes das salas, os pais, a pré-ordem e a árvore de segmentos
+// do ancestral comum, em tempo e memória O(n). A mansão é vista como a árvore da
+// busca a partir da entrada: se uma sala é citada por dois caminhos, vale o primeiro.
+// Como prepararCaso, deve ser chamada antes de o caso ser compartilhado.
+void prepararNavegacao(Caso *caso) {
+    Mansao *m = &caso->mansao;
+    if (m->pai != NULL) return;
+    indexarTabela(&m->nomes);
+    unsigned int total = numSalas(caso);
+    m->pai = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, total, sizeof(unsigned int));
+    m->profundidade = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, total, sizeof(unsigned int));
+    m->entrada = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, total, sizeof(unsigned int));
+    m->saida = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, total, sizeof(unsigned int));
+    m->ordem = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, total, sizeof(unsigned int));
+    memset(m->pai, 0, total * sizeof(unsigned int));
+    memset(m->entrada, 0xFF, total * sizeof(unsigned int));
+
+    // Busca em profundidade com pilha explícita ('saida' serve de pilha até o fim);
+    // a esquerda é empilhada por último para ser visitada primeiro. 'entrada' = total
+    // marca as salas já empilhadas.
+    unsigned int *pilha = m->saida;
+    unsigned int topo = 0, posicao = 0;
+    pilha[topo++] = SALA_INICIAL;
+    m->entrada[SALA_INICIAL] = total;
+    m->profundidade[SALA_INICIAL] = 0;
+    while (topo > 0) {
+        unsigned int sala = pilha[--topo];
+        m->entrada[sala] = posicao;
+        m->ordem[posicao++] = sala;
+        unsigned int filhos[2] = {m->salas[sala].direita, m->salas[sala].esquerda};
+        for (int i = 0; i < 2; i++) {
+            unsigned int filho = filhos[i];
+            if (filho != SEM_TEXTO && filho < total && m->entrada[filho] == NAO_ALCANCADA) {
+                m->entrada[filho] = total;
+                m->pai[filho] = sala;
+                m->profundidade[filho] = m->profundidade[sala] + 1;
+                pilha[topo++] = filho;
+            }
+        }
+    }
+    m->numAlcancadas = posicao;
+
+    // Tamanho das subárvores, das folhas para a entrada (pré-ordem invertida): quando
+    // uma sala é alcançada aqui, todos os seus descendentes já somaram nela.
+    for (unsigned int p = 0; p < posicao; p++) m->saida[m->ordem[p]] = 1;
+    for (unsigned int p = posicao; p-- > 0;) {
+        unsigned int sala = m->ordem[p];
+        unsigned int tamanho = m->saida[sala];
+        if (sala != SALA_INICIAL) m->saida[m->pai[sala]] += tamanho;
+        m->saida[sala] = p + tamanho;
+    }
+
+    m->folhas = 1;
+    while (m->folhas < posicao) m->folhas *= 2;
+    m->maisRasa = (unsigned int*) crescerNaArena(&caso->arena, NULL, 0, 2 * (size_t) m->folhas, sizeof(unsigned int));
+    for (unsigned int p = 0; p < m->folhas; p++) m->maisRasa[m->folhas + p] = p < posicao ? p : NAO_ALCANCADA;
+    montarMaisRasa(m, m->maisRasa);
+}
+
+// Monta, depois de prepararNavegacao, a decomposição por centroides da pista mais
+// próxima. Ela custa O(n log n) em tempo e memória, então o jogo interativo só a
+// monta quando o jogador pede a pista mais próxima pela primeira vez. Num caso
+// compartilhado, deve ser chamada antes de ele ser compartilhado.
+void prepararPistaMaisProxima(Caso *caso) {
+    if (caso->mansao.pai == NULL || caso->mansao.paiCentroide != NULL) return;
+    montarCentroides(caso);
+}
+
+// Índice da sala com esse nome, ou SEM_TEXTO.
+unsigned int buscarSala(const Caso *caso, const char *nome) {
+    return buscarIdTexto(&caso->mansao.nomes, nome);
+}
+
+int salaAlcancavel(const Caso *caso, unsigned int sala) {
+    return sala != SEM_TEXTO && sala < numSalas(caso) && caso->mansao.entrada[sala] != NAO_ALCANCADA;
+}
+
+// Ancestral comum mais próximo de duas salas alcançáveis, em O(log n): entre as
+// posições (entrada[a], entrada[b]] da pré-ordem, a sala mais rasa é filha dele.
+unsigned int ancestralComum(const Caso *caso, unsigned int a, unsigned int b) {
+    const Mansao *m = &caso->mansao;
+    if (a == b) return a;
+    unsigned int pa = m->entrada[a], pb = m->entrada[b];
+    if (pa > pb) {
+        unsigned int temp = pa; pa = pb; pb = temp;
+    }
+    return m->pai[m->ordem[consultarMaisRasa(m, m->maisRasa, pa + 1, pb + 1)]];
+}
+
+// Número de passos entre duas salas alcançáveis.
+unsigned int distanciaEntreSalas(const Caso *caso, unsigned int a, unsigned int b) {
+    const Mansao *m = &caso->mansao;
+    return m->profundidade[a] + m->profundidade[b] - 2 * m->profundidade[ancestralComum(caso, a, b)];
+}
+
+// Escreve em 'passos' o caminho de 'origem' até 'destino': 'v' (voltar à sala
+// anterior) até o ancestral comum, depois 'e' e 'd', terminado em '\0'. Devolve o
+// número de passos, ou -1 se alguma sala não é alcançável ou o caminho não cabe
+// em 'max' caracteres. Só o caminho é percorrido: O(log n + passos).
+int rotaEntreSalas(const Caso *caso, unsigned int origem, unsigned int destino, char *passos, size_t max) {
+    const Mansao *m = &caso->mansao;
+    if (!salaAlcancavel(caso, origem) || !salaAlcancavel(caso, destino)) return -1;
+    unsigned int comum = ancestralComum(caso, origem, destino);
+    size_t subida = m->profundidade[origem] - m->profundidade[comum];
+    size_t total = subida + m->profundidade[destino] - m->profundidade[comum];
+    if (total + 1 > max) return -1;
+    memset(passos, 'v', subida);
+    passos[total] = '\0';
+    size_t pos = total;
+    for (unsigned int sala = destino; sala != comum; sala = m->pai[sala]) {
+        passos[--pos] = m->salas[m->pai[sala]].esquerda == sala ? 'e' : 'd';
+    }
+    return (int) total;
+}
+
+// Primeira entrada a partir de 'i' da lista do centroide 'c' que a partida ainda não recolheu.
+static unsigned int pularRecolhidas(const Jogo *jogo, unsigned int c, unsigned int i) {
+    const Mansao *m = &jogo->caso->mansao;
+    for (; i < m->fimPistas[c]; i++) {
+        unsigned int sala = m->ordem[m->pistaPerto[i]];
+        if (!(jogo->pistaColetada[sala / 64] & (1ull << (sala % 64)))) break;
+    }
+    return i;
+}
+
+// Põe o cursor da partida em cada lista de centroide, se o caso já tiver os
+// centroides. A partida pode ter começado antes deles, então o que ela já
+// recolheu é pulado aqui.
+static void acompanharCentroides(Jogo *jogo) {
+    const Mansao *m = &jogo->caso->mansao;
+    if (jogo->proximaPista != NULL || m->paiCentroide == NULL) return;
+    jogo->proximaPista = (unsigned int*) crescerNaArena(&jogo->arena, NULL, 0, m->numAlcancadas, sizeof(unsigned int));
+    for (unsigned int c = 0; c < m->numAlcancadas; c++) jogo->proximaPista[c] = pularRecolhidas(jogo, c, m->inicioPistas[c]);
+}
+
+// A árvore de segmentos da partida guarda, para cada intervalo da pré-ordem, a
+// posição da sala mais rasa que ainda tem pista para recolher. Só existe se o caso
+// tiver navegação; os cursores dos centroides, só se ele também tiver centroides.
+static void inicializarPistasPendentes(Jogo *jogo) {
+    const Mansao *m = &jogo->caso->mansao;
+    jogo->pistaMaisRasa = NULL;
+    jogo->proximaPista = NULL;
+    if (m->pai == NULL) return;
+    acompanharCentroides(jogo);
+    jogo->pistaMaisRasa = (unsigned int*) crescerNaArena(&jogo->arena, NULL, 0, 2 * (size_t) m->folhas, sizeof(unsigned int));
+    for (unsigned int p = 0; p < m->folhas; p++) {
+        int temPista = p < m->numAlcancadas && m->salas[m->ordem[p]].pista != SEM_TEXTO;
+        jogo->pistaMaisRasa[m->folhas + p] = temPista ? p : NAO_ALCANCADA;
+    }
+    montarMaisRasa(m, jogo->pistaMaisRasa);
+}
+
+static void marcarPistaRecolhida(Jogo *jogo, unsigned int sala) {
+    const Mansao *m = &jogo->caso->mansao;
+    if (jogo->pistaMaisRasa == NULL || m->entrada[sala] == NAO_ALCANCADA) return;
+    unsigned int no = m->folhas + m->entrada[sala];
+    jogo->pistaMaisRasa[no] = NAO_ALCANCADA;
+    for (no /= 2; no >= 1; no /= 2) {
+        jogo->pistaMaisRasa[no] = maisRasaEntre(m, jogo->pistaMaisRasa[2 * no], jogo->pistaMaisRasa[2 * no + 1]);
+    }
+    // Os centroides acima da sala pulam o começo já recolhido das suas listas. Cada
+    // entrada é pulada uma vez por partida, então isto custa O(log n) amortizado.
+    if (jogo->proximaPista == NULL) return;
+    for (unsigned int c = m->entrada[sala]; c != NAO_ALCANCADA; c = m->paiCentroide[c]) {
+        jogo->proximaPista[c] = pularRecolhidas(jogo, c, jogo->proximaPista[c]);
+    }
+}
+
+// Sala mais perto de 'sala' (em passos) com pista ainda não recolhida, ou SEM_TEXTO.
+// O caminho até ela passa por um dos centroides acima de 'sala', e cada centroide
+// já sabe a pista pendente mais perto dele no seu pedaço: basta somar as duas
+// distâncias em cada um dos no máximo 'niveis' centroides. O(log n) por consulta.
+// Sem os centroides (ver prepararPistaMaisProxima) não há resposta: SEM_TEXTO.
+unsigned int pistaMaisProxima(const Jogo *jogo, unsigned int sala, unsigned int *distancia) {
+    const Mansao *m = &jogo->caso->mansao;
+    unsigned int melhor = SEM_TEXTO, melhorDistancia = NAO_ALCANCADA;
+    if (jogo->proximaPista != NULL && salaAlcancavel(jogo->caso, sala)) {
+        const unsigned int *distancias = m->distanciaCentroide + (size_t) m->entrada[sala] * m->niveis;
+        for (unsigned int c = m->entrada[sala]; c != NAO_ALCANCADA; c = m->paiCentroide[c]) {
+            unsigned int i = jogo->proximaPista[c];
+            if (i == m->fimPistas[c]) continue;
+            unsigned int d = distancias[m->nivelCentroide[c]] + m->distanciaPista[i];
+            if (d < melhorDistancia) {
+                melhorDistancia = d;
+                melhor = m->ordem[m->pistaPerto[i]];
+            }
+        }
+    }
+    if (distancia != NULL) *distancia = melhorDistancia;
+    return melhor;
+}
+
+// Copia para 'destino' (até 'max') as salas da subárvore de 'sala' que ainda têm
+// pista, na ordem de visita. Só desce pelos ramos da árvore de segmentos que têm
+// alguma pista: O((k + 1) log n) para k salas. Devolve quantas copiou.
+int salasComPistaNaSubarvore(const Jogo *jogo, unsigned int sala, unsigned int *destino, int max) {
+    const Mansao *m = &jogo->caso->mansao;
+    if (jogo->pistaMaisRasa == NULL || !salaAlcancavel(jogo->caso, sala)) return 0;
+    unsigned int inicio = m->entrada[sala], fim = m->saida[sala];
+    struct { unsigned int no, primeira, tamanho; } pilha[64];
+    int topo = 0, total = 0;
+    pilha[topo].no = 1; pilha[topo].primeira = 0; pilha[topo].tamanho = m->folhas; topo++;
+    while (topo > 0 && total < max) {
+        topo--;
+        unsigned int no = pilha[topo].no, primeira = pilha[topo].primeira, tamanho = pilha[topo].tamanho;
+        if (jogo->pistaMaisRasa[no] == NAO_ALCANCADA || primeira >= fim || primeira + tamanho <= inicio) continue;
+        if (tamanho == 1) {
+            destino[total++] = m->ordem[primeira];
+            continue;
+        }
+        unsigned int metade = tamanho / 2;
+        pilha[topo].no = 2 * no + 1; pilha[topo].primeira = primeira + metade; pilha[topo].tamanho = metade; topo++;
+        pilha[topo].no = 2 * no; pilha[topo].primeira = primeira; pilha[topo].tamanho = metade; topo++;
+    }
+    return total;
+}
+
+
+// --- 8. MÓDULO DA EXPLORAÇÃO E DO JULGAMENTO ---
+
+// Recolhe a pista da sala (se a partida ainda não a recolheu) para a árvore e para
+// os contadores. A sala do caso não muda; quem lembra da coleta é a partida.
+// Devolve a pista recolhida, ou SEM_TEXTO.
+IdTexto coletarPista(Jogo *jogo, unsigned int sala, NoPista** raizPistas) {
+    IdTexto pista = jogo->caso->mansao.salas[sala].pista;
+    uint64_t bit = 1ull << (sala % 64);
+    if (pista == SEM_TEXTO || (jogo->pistaColetada[sala / 64] & bit)) return SEM_TEXTO;
+    jogo->pistaColetada[sala / 64] |= bit;
+    marcarPistaRecolhida(jogo, sala);
+    int nova;
+    *raizPistas = inserirPista(jogo, *raizPistas, pista, &nova);
+    if (nova) registrarEvidencia(jogo, pista);
+    return pista;
+}
+
+// Mostra o caminho da sala atual até 'destino' como uma sequência de passos.
+static void mostrarRota(Tela *tela, Jogo *jogo, unsigned int atual, unsigned int destino) {
+    size_t tam = (size_t) distanciaEntreSalas(jogo->caso, atual, destino) + 1;
+    char *passos = (char*) malloc(tam);
+    int n = rotaEntreSalas(jogo->caso, atual, destino, passos, tam);
+    telaEscrever(tela, "Rota ate %s (%d passos): %s\n", nomeDaSala(jogo->caso, destino), n, n > 0 ? passos : "voce ja esta la");
+    free(passos);
+}
+
+// Consultas de navegação do modo interativo (só com prepararNavegacao). Devolve 1
+// se 'escolha' era uma delas.
+static int consultarNavegacao(Tela *tela, Jogo *jogo, unsigned int atual, char escolha) {
+    if (jogo->pistaMaisRasa == NULL) return 0;
+    if (escolha == 'p') {
+        // Os centroides só são montados quando a pista mais próxima é pedida.
+        if (jogo->proximaPista == NULL && jogo->casoExclusivo != NULL) {
+            prepararPistaMaisProxima(jogo->casoExclusivo);
+            acompanharCentroides(jogo);
+        }
+        unsigned int sala = pistaMaisProxima(jogo, atual, NULL);
+        if (sala == SEM_TEXTO) telaEscrever(tela, "Nao restam pistas ao seu alcance.\n");
+        else mostrarRota(tela, jogo, atual, sala);
+    } else if (escolha == 'r') {
+        char nome[100];
+        telaEscrever(tela, "Nome da sala: ");
+        telaMostrar(tela);
+        if (scanf(" %99[^\n]", nome) != 1) return 1;
+        unsigned int sala = buscarSala(jogo->caso, nome);
+        if (!salaAlcancavel(jogo->caso, sala)) telaEscrever(tela, "Sala desconhecida.\n");
+        else mostrarRota(tela, jogo, atual, sala);
+    } else if (escolha == 'l') {
+        unsigned int salas[10];
+        int n = salasComPistaNaSubarvore(jogo, atual, salas, 10);
+        telaEscrever(tela, n ? "Salas com pistas a partir daqui:\n" : "Nenhuma pista a partir daqui.\n");
+        for (int i = 0; i < n; i++) telaEscrever(tela, "  - %s\n", nomeDaSala(jogo->caso, salas[i]));
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+// Cada passo da exploração é um quadro montado na Tela (mensagens do passo
+// anterior, sala, caminhos e pergunta) e escrito de uma vez antes de ler a escolha.
+void explorarSalas(Jogo *jogo, unsigned int salaInicial, NoPista** raizPistas) {
+    const Mansao *m = &jogo->caso->mansao;
+    unsigned int atual = salaInicial;
+    char escolha;
+    Tela tela;
+    telaInicializar(&tela, 1, TELA_FLUXO);
+    telaEscrever(&tela, "Voce esta no(a) %s. A mansao e vasta e escura...\n", nomeDaSala(jogo->caso, atual));
+    while (atual != SEM_TEXTO) {
+        const Sala* salaAtual = &jogo->caso->mansao.salas[atual];
+        IdTexto pista = coletarPista(jogo, atual, raizPistas);
+        if (pista != SEM_TEXTO) {
+            telaEscrever(&tela, "Voce encontrou algo! Pista: [ %s ]\n", textoDoId(&jogo->caso->pistas, pista));
+        }
+        telaEscrever(&tela, "\nVoce esta no(a): %s\n", nomeDaSala(jogo->caso, atual));
+        telaEscrever(&tela, "Caminhos disponiveis:\n");
+        if (salaAtual->esquerda) telaEscrever(&tela, "  (e)squerda -> %s\n", nomeDaSala(jogo->caso, salaAtual->esquerda));
+        if (salaAtual->direita) telaEscrever(&tela, "  (d)ireita -> %s\n", nomeDaSala(jogo->caso, salaAtual->direita));
+        if (jogo->pistaMaisRasa != NULL) {
+            if (m->pai[atual]) telaEscrever(&tela, "  (v)oltar -> %s\n", nomeDaSala(jogo->caso, m->pai[atual]));
+            telaEscrever(&tela, "  (p)ista mais proxima | (r)ota ate uma sala | (l)istar salas com pistas a partir daqui\n");
+        }
+        telaEscrever(&tela, "  (s)air da exploracao e ir para o julgamento\n");
+        telaEscrever(&tela, "Para onde voce vai? ");
+        telaMostrar(&tela);
+        telaLimpar(&tela);
+        if (scanf(" %c", &escolha) != 1) break;
+        escolha = tolower(escolha);
+        if (escolha == 'e' && salaAtual->esquerda != SEM_TEXTO) {
+            atual = salaAtual->esquerda;
+        } else if (escolha == 'd' && salaAtual->direita != SEM_TEXTO) {
+            atual = salaAtual->direita;
+        } else if (escolha == 'v' && jogo->pistaMaisRasa != NULL && m->pai[atual] != SEM_TEXTO) {
+            atual = m->pai[atual];
+        } else if (consultarNavegacao(&tela, jogo, atual, escolha)) {
+            continue;
+        } else if (escolha == 's') {
+            telaEscrever(&tela, "\nVoce sente que ja tem o suficiente. Hora de acusar o culpado.\n");
+            break;
+        } else {
+            telaEscrever(&tela, "Caminho invalido. Tente novamente.\n");
+        }
+    }
+    telaMostrar(&tela);
+    telaLiberar(&tela);
+}
+
+void verificarSuspeitoFinal(Jogo *jogo, NoPista* raizPistas) {
+    char acusado[50];
+    printf("\n--- O JULGAMENTO ---\n");
+    if (raizPistas == NULL) {
+        printf("Voce nao coletou nenhuma pista. O caso permanece um misterio.\n");
+        return;
+    }
+    printf("Pistas que voce coletou:\n");
+    mostrarPistas(jogo, raizPistas);
+    // Os suspeitos são os do caso carregado, na ordem em que o mapa os cita.
+    const TabelaStrings *suspeitos = &jogo->caso->suspeitos;
+    printf("\nSuspeitos: ");
+    for (IdTexto s = 1; s < suspeitos->quantidade; s++) {
+        printf("%s%s", s > 1 ? ", " : "", textoDoId(suspeitos, s));
+    }
+    printf("\n");
+    printf("Com base nas evidencias, quem voce acusa? ");
+    scanf("%49s", acusado); // Limita a entrada para evitar overflow
+    IdTexto idAcusado = buscarIdTexto(&jogo->caso->suspeitos, acusado);
+    int numPistas = evidenciasContra(jogo, idAcusado);
+    printf("\nAnalisando as evidencias contra %s...\n", acusado);
+    printf("Numero de pistas encontradas: %d\n", numPistas);
+    if (numPistas >= 2) {
+        printf("\nVEREDITO: CULPADO! As provas sao contundentes. Voce solucionou o caso!\n");
+    } else {
+        printf("\nVEREDITO: INOCENTE! Voce acusou a pessoa errada. O verdadeiro culpado escapou...\n");
+    }
+
+    int max = (int) suspeitos->quantidade - 1;
+    IdTexto *ranking = (IdTexto*) malloc((max > 0 ? max : 1) * sizeof(IdTexto));
+    int total = listarRankingSuspeitos(jogo, ranking, max);
+    printf("\nEvidencias por suspeito:\n");
+    for (int i = 0; i < total; i++) {
+        printf("  %d. %-20s %d\n", i + 1, textoDoId(suspeitos, ranking[i]), evidenciasContra(jogo, ranking[i]));
+    }
+    free(ranking);
+}
+
+// --- 9. MÓDULO DE MAPAS (TEXTO E COMPILADO) ---
+
+// Formato texto, uma declaração por linha, campos separados por '|':
+//   sala|<nome>|<pista ou vazio>|<sala da esquerda ou vazio>|<sala da direita ou vazio>
+//   suspeito|<pista>|<suspeito>
+// Linhas vazias e iniciadas por '#' são ignoradas. A primeira sala declarada é a
+// entrada da mansão; uma sala pode ser citada como caminho antes de ser declarada.
+static const char MAPA_PADRAO[] =
+    "sala|Hall de Entrada||Biblioteca|Sala de Jantar\n"
+    "sala|Biblioteca|Um livro sobre venenos estava fora do lugar.|Escritorio|Jardim de Inverno\n"
+    "sala|Sala de Jantar|Um frasco quebrado com um liquido suspeito.||Cozinha\n"
+    "sala|Escritorio|Uma carta de ameaca enderecada a vitima.||\n"
+    "sala|Jardim de Inverno|Pegadas de botas sujas de terra.||\n"
+    "sala|Cozinha|Uma faca afiada desapareceu do conjunto.|Despensa|\n"
+    "sala|Despensa|Um recibo de compra de luvas de couro.||\n"
+    "suspeito|Um livro sobre venenos estava fora do lugar.|Governanta\n"
+    "suspeito|Um frasco quebrado com um liquido suspeito.|Dama_de_Companhia\n"
+    "suspeito|Uma carta de ameaca enderecada a vitima.|Jardineiro\n"
+    "suspeito|Pegadas de botas sujas de terra.|Jardineiro\n"
+    "suspeito|Uma faca afiada desapareceu do conjunto.|Mordomo\n"
+    "suspeito|Um recibo de compra de luvas de couro.|Mordomo\n";
+
+// Formato compilado: este cabeçalho seguido das seções, cada uma alinhada a 8 bytes.
+// As posições são contadas a partir do início do arquivo. Os números são gravados
+// na ordem de bytes da máquina que compilou o mapa.
+#define MAGICA_MAPA "DQMAPA01"
+
+typedef struct SecaoStrings {
+    uint64_t deslocamentos; // unsigned int[quantidade]
+    uint64_t textos;        // char[tamTextos]
+    uint64_t tamTextos;
+    uint32_t quantidade;    // inclui o id 0
+    uint32_t reservado;
+} SecaoStrings;
+
+typedef struct CabecalhoMapa {
+    char magica[8];
+    uint64_t tamArquivo;
+    uint64_t salas;           // Sala[nomes.quantidade]
+    uint64_t suspeitoDaPista; // IdTexto[pistas.quantidade]
+    SecaoStrings nomes, pistas, suspeitos;
+} CabecalhoMapa;
+
+// Separa a linha em até 'max' campos, trocando '|' por '\0'. Devolve quantos achou.
+static int separarCampos(char *linha, char **campos, int max) {
+    int n = 0;
+    campos[n++] = linha;
+    for (char *c = linha; *c; c++) {
+        if (*c == '|' && n < max) {
+            *c = '\0';
+            campos[n++] = c + 1;
+        }
+    }
+    return n;
+}
+
+// Explica por que o mapa não carregou: em caso->erro, se quem carrega pediu, ou em stderr.
+static void falhaNaCarga(Caso *caso, const char *formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    if (caso->erro != NULL) {
+        vsnprintf(caso->erro, caso->tamErro, formato, args);
+    } else {
+        vfprintf(stderr, formato, args);
+        fputc('\n', stderr);
+    }
+    va_end(args);
+}
+
+// Lê um mapa em formato texto (o buffer é modificado). Devolve 0 se tudo deu certo.
+int lerMapaTexto(Caso *caso, char *conteudo) {
+    int numLinha = 0;
+    char *linha = conteudo;
+    while (linha != NULL && *linha) {
+        char *fim = strchr(linha, '\n');
+        char *proxima = NULL;
+        if (fim) {
+            *fim = '\0';
+            proxima = fim + 1;
+        }
+        size_t tam = strlen(linha);
+        if (tam > 0 && linha[tam - 1] == '\r') linha[tam - 1] = '\0';
+        numLinha++;
+
+        char *campos[5];
+        if (linha[0] != '\0' && linha[0] != '#') {
+            int n = separarCampos(linha, campos, 5);
+            if (strcmp(campos[0], "sala") == 0 && n == 5 && campos[1][0] != '\0') {
+                unsigned int sala = criarSala(caso, campos[1], campos[2]);
+                unsigned int esquerda = campos[3][0] ? obterSala(caso, campos[3]) : SEM_TEXTO;
+                unsigned int direita = campos[4][0] ? obterSala(caso, campos[4]) : SEM_TEXTO;
+                caso->mansao.salas[sala].esquerda = esquerda;
+                caso->mansao.salas[sala].direita = direita;
+            } else if (strcmp(campos[0], "suspeito") == 0 && n == 3 && campos[1][0] && campos[2][0]) {
+                inserirNaHash(caso, campos[1], campos[2]);
+            } else {
+                falhaNaCarga(caso, "Linha %d do mapa invalida.", numLinha);
+                return 1;
+            }
+        }
+        linha = proxima;
+    }
+    if (numSalas(caso) <= SALA_INICIAL) {
+        falhaNaCarga(caso, "O mapa nao tem nenhuma sala.");
+        return 1;
+    }
+    return 0;
+}
+
+static uint64_t alinhar8(uint64_t posicao) {
+    return (posicao + 7) & ~(uint64_t) 7;
+}
+
+// As seções são gravadas em ordem; 'escrito' acompanha a posição atual no arquivo.
+static void gravarSecao(FILE *arquivo, uint64_t *escrito, uint64_t posicao, const void *dados, size_t tamanho) {
+    static const char zeros[8] = {0};
+    fwrite(zeros, 1, (size_t) (posicao - *escrito), arquivo);
+    if (tamanho > 0) fwrite(dados, 1, tamanho, arquivo);
+    *escrito = posicao + tamanho;
+}
+
+static uint64_t planejarStrings(SecaoStrings *secao, const TabelaStrings *t, uint64_t posicao) {
+    secao->quantidade = t->quantidade;
+    secao->reservado = 0;
+    secao->deslocamentos = posicao;
+    posicao = alinhar8(posicao + (uint64_t) t->quantidade * sizeof(unsigned int));
+    secao->textos = posicao;
+    secao->tamTextos = t->usoTextos;
+    return alinhar8(posicao + t->usoTextos);
+}
+
+// Grava a mansão, as pistas e os suspeitos carregados no formato compilado.
+int compilarMapa(const Caso *caso, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        fprintf(stderr, "Nao foi possivel criar %s.\n", caminho);
+        return 1;
+    }
+    CabecalhoMapa cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_MAPA, 8);
+    uint64_t pos = alinhar8(sizeof(cab));
+    cab.salas = pos;
+    pos = alinhar8(pos + (uint64_t) numSalas(caso) * sizeof(Sala));
+    cab.suspeitoDaPista = pos;
+    pos = alinhar8(pos + (uint64_t) caso->pistas.quantidade * sizeof(IdTexto));
+    pos = planejarStrings(&cab.nomes, &caso->mansao.nomes, pos);
+    pos = planejarStrings(&cab.pistas, &caso->pistas, pos);
+    pos = planejarStrings(&cab.suspeitos, &caso->suspeitos, pos);
+    cab.tamArquivo = pos;
+
+    // Pistas sem suspeito ficam além do fim de 'suspeitoDaPista' e viram SEM_TEXTO.
+    IdTexto *suspeitosDasPistas = (IdTexto*) calloc(caso->pistas.quantidade, sizeof(IdTexto));
+    for (IdTexto p = 0; p < caso->pistas.quantidade; p++) suspeitosDasPistas[p] = suspeitoDoIdPista(caso, p);
+
+    uint64_t escrito = 0;
+    gravarSecao(arquivo, &escrito, 0, &cab, sizeof(cab));
+    gravarSecao(arquivo, &escrito, cab.salas, caso->mansao.salas, numSalas(caso) * sizeof(Sala));
+    gravarSecao(arquivo, &escrito, cab.suspeitoDaPista, suspeitosDasPistas, caso->pistas.quantidade * sizeof(IdTexto));
+    const SecaoStrings *secoes[3] = {&cab.nomes, &cab.pistas, &cab.suspeitos};
+    const TabelaStrings *tabelas[3] = {&caso->mansao.nomes, &caso->pistas, &caso->suspeitos};
+    for (int i = 0; i < 3; i++) {
+        gravarSecao(arquivo, &escrito, secoes[i]->deslocamentos, tabelas[i]->deslocamentos, tabelas[i]->quantidade * sizeof(unsigned int));
+        gravarSecao(arquivo, &escrito, secoes[i]->textos, tabelas[i]->textos, tabelas[i]->usoTextos);
+    }
+    gravarSecao(arquivo, &escrito, cab.tamArquivo, NULL, 0); // alinhamento final
+    free(suspeitosDasPistas);
+    int erro = ferror(arquivo);
+    fclose(arquivo);
+    return erro ? 1 : 0;
+}
+
+// Mapeia o arquivo inteiro em memória, só para leitura: as partidas guardam o que
+// coletaram no próprio estado, nunca nas salas.
+static void* mapearArquivo(const char *caminho, size_t *tamanho) {
+#if defined(_WIN32)
+    HANDLE arquivo = CreateFileA(caminho, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (arquivo == INVALID_HANDLE_VALUE) return NULL;
+    LARGE_INTEGER tam;
+    GetFileSizeEx(arquivo, &tam);
+    HANDLE mapeamento = CreateFileMappingA(arquivo, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(arquivo);
+    if (mapeamento == NULL) return NULL;
+    void *dados = MapViewOfFile(mapeamento, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapeamento);
+    *tamanho = (size_t) tam.QuadPart;
+    return dados;
+#else
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    void *dados = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (dados == MAP_FAILED) return NULL;
+    *tamanho = (size_t) info.st_size;
+    return dados;
+#endif
+}
+
+static void desmapearArquivo(void *dados, size_t tamanho) {
+#if defined(_WIN32)
+    (void) tamanho;
+    UnmapViewOfFile(dados);
+#else
+    munmap(dados, tamanho);
+#endif
+}
+
+static int secaoValida(uint64_t posicao, uint64_t tamanho, uint64_t tamArquivo) {
+    return posicao % 8 == 0 && posicao <= tamArquivo && tamanho <= tamArquivo - posicao;
+}
+
+static int adotarSecao(Caso *caso, TabelaStrings *t, const SecaoStrings *secao, char *base, size_t tamArquivo) {
+    if (secao->quantidade == 0 || secao->tamTextos == 0
+        || !secaoValida(secao->deslocamentos, (uint64_t) secao->quantidade * sizeof(unsigned int), tamArquivo)
+        || !secaoValida(secao->textos, secao->tamTextos, tamArquivo)
+        || base[secao->textos + secao->tamTextos - 1] != '\0') {
+        return 1;
+    }
+    adotarTabelaStrings(t, &caso->arena, base + secao->textos, (size_t) secao->tamTextos,
+                        (unsigned int*) (base + secao->deslocamentos), secao->quantidade);
+    return 0;
+}
+
+// Cada texto de uma tabela adotada começa depois do anterior e termina com '\0'
+// logo antes do seguinte; o id 0 é o texto vazio do início.
+static int textosCoerentes(const TabelaStrings *t) {
+    if (t->deslocamentos[0] != 0) return 0;
+    for (IdTexto id = 0; id < t->quantidade; id++) {
+        size_t fim = id + 1 < t->quantidade ? t->deslocamentos[id + 1] : t->usoTextos;
+        if (fim <= t->deslocamentos[id] || fim > t->usoTextos || t->textos[fim - 1] != '\0') return 0;
+    }
+    return 1;
+}
+
+// Confere numa passada tudo o que as partidas usam sem verificar: os textos das
+// três tabelas, os caminhos e a pista de cada sala e o suspeito de cada pista.
+static int mapaCoerente(const TabelaStrings *nomes, const TabelaStrings *pistas, const TabelaStrings *suspeitos,
+                        const Sala *salas, const IdTexto *suspeitoDaPista) {
+    if (!textosCoerentes(nomes) || !textosCoerentes(pistas) || !textosCoerentes(suspeitos)) return 0;
+    unsigned int total = nomes->quantidade;
+    if (total <= SALA_INICIAL) return 0;
+    for (unsigned int sala = 0; sala < total; sala++) {
+        if (salas[sala].esquerda >= total || salas[sala].direita >= total || salas[sala].pista >= pistas->quantidade) {
+            return 0;
+        }
+    }
+    for (IdTexto pista = 0; pista < pistas->quantidade; pista++) {
+        if (suspeitoDaPista[pista] >= suspeitos->quantidade) return 0;
+    }
+    return 1;
+}
+
+// Usa o mapa compilado direto da memória mapeada: nenhuma sala, pista ou texto é copiado.
+// O arquivo é conferido por inteiro uma vez (mapaCoerente) antes de ser usado, então
+// um mapa corrompido é recusado em vez de levar a leituras fora dele. As tabelas só
+// passam para o caso depois disso: um mapa recusado deixa o caso como estava.
+int abrirMapaCompilado(Caso *caso, const char *caminho) {
+    size_t tamanho;
+    char *base = (char*) mapearArquivo(caminho, &tamanho);
+    if (base == NULL) {
+        falhaNaCarga(caso, "Nao foi possivel abrir %s.", caminho);
+        return 1;
+    }
+    const CabecalhoMapa *cab = (const CabecalhoMapa*) base;
+    TabelaStrings nomes, pistas, suspeitos;
+    if (tamanho < sizeof(CabecalhoMapa) || memcmp(cab->magica, MAGICA_MAPA, 8) != 0 || cab->tamArquivo != tamanho
+        || adotarSecao(caso, &nomes, &cab->nomes, base, tamanho) != 0
+        || adotarSecao(caso, &pistas, &cab->pistas, base, tamanho) != 0
+        || adotarSecao(caso, &suspeitos, &cab->suspeitos, base, tamanho) != 0
+        || !secaoValida(cab->salas, (uint64_t) cab->nomes.quantidade * sizeof(Sala), tamanho)
+        || !secaoValida(cab->suspeitoDaPista, (uint64_t) cab->pistas.quantidade * sizeof(IdTexto), tamanho)
+        || !mapaCoerente(&nomes, &pistas, &suspeitos, (const Sala*) (base + cab->salas),
+                         (const IdTexto*) (base + cab->suspeitoDaPista))) {
+        falhaNaCarga(caso, "%s nao e um mapa compilado valido.", caminho);
+        desmapearArquivo(base, tamanho);
+        return 1;
+    }
+    caso->mansao.nomes = nomes;
+    caso->pistas = pistas;
+    caso->suspeitos = suspeitos;
+    caso->mansao.salas = (Sala*) (base + cab->salas);
+    caso->mansao.capSalas = cab->nomes.quantidade;
+    caso->mansao.mapa = base;
+    caso->mansao.tamMapa = tamanho;
+    caso->suspeitoDaPista = (IdTexto*) (base + cab->suspeitoDaPista);
+    caso->capSuspeitoDaPista = cab->pistas.quantidade;
+    return 0;
+}
+
+// Carrega um mapa em qualquer um dos dois formatos, reconhecendo o compilado pela
+// assinatura. Deve ser chamado logo depois de inicializar a mansão e as pistas.
+int carregarMapa(Caso *caso, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        falhaNaCarga(caso, "Nao foi possivel abrir %s.", caminho);
+        return 1;
+    }
+    char magica[8] = {0};
+    size_t lidos = fread(magica, 1, sizeof(magica), arquivo);
+    if (lidos == sizeof(magica) && memcmp(magica, MAGICA_MAPA, 8) == 0) {
+        fclose(arquivo);
+        return abrirMapaCompilado(caso, caminho);
+    }
+    fseek(arquivo, 0, SEEK_END);
+    long tamanho = ftell(arquivo);
+    if (tamanho < 0) { // entrada que não aceita fseek (um pipe, por exemplo)
+        fclose(arquivo);
+        falhaNaCarga(caso, "Nao foi possivel medir %s.", caminho);
+        return 1;
+    }
+    fseek(arquivo, 0, SEEK_SET);
+    char *conteudo = (char*) malloc((size_t) tamanho + 1);
+    size_t total = fread(conteudo, 1, (size_t) tamanho, arquivo);
+    conteudo[total] = '\0';
+    fclose(arquivo);
+    int erro = lerMapaTexto(caso, conteudo);
+    free(conteudo);
+    return erro;
+}
+
+// Carrega o mapa do arquivo ou, sem caminho, o caso padrão.
+int carregarCaso(Caso *caso, const char *caminho) {
+    if (caminho != NULL) return carregarMapa(caso, caminho);
+    char *padrao = strdup(MAPA_PADRAO);
+    int erro = lerMapaTexto(caso, padrao);
+    free(padrao);
+    return erro;
+}
+
+void liberarMansao(Caso *caso) {
+    if (caso->mansao.mapa != NULL) desmapearArquivo(caso->mansao.mapa, caso->mansao.tamMapa);
+    caso->mansao.mapa = NULL;
+}
+
+// Escreve em formato texto uma mansão completa de n salas (a sala i leva às salas
+// 2i e 2i+1), com uma pista por sala distribuída entre quatro suspeitos.
+int gerarMapa(unsigned int n, const char *caminho) {
+    static const char* suspeitosGerados[] = {"Mordomo", "Jardineiro", "Governanta", "Dama_de_Companhia"};
+    FILE *arquivo = fopen(caminho, "w");
+    if (arquivo == NULL) {
+        fprintf(stderr, "Nao foi possivel criar %s.\n", caminho);
+        return 1;
+    }
+    for (unsigned int i = 1; i <= n; i++) {
+        fprintf(arquivo, "sala|Sala %u|Pista %u: um vestigio deixado na sala %u.|", i, i, i);
+        if (2ull * i <= n) fprintf(arquivo, "Sala %u", 2 * i);
+        fputc('|', arquivo);
+        if (2ull * i + 1 <= n) fprintf(arquivo, "Sala %u", 2 * i + 1);
+        fputc('\n', arquivo);
+    }
+    for (unsigned int i = 1; i <= n; i++) {
+        fprintf(arquivo, "suspeito|Pista %u: um vestigio deixado na sala %u.|%s\n", i, i, suspeitosGerados[i % 4]);
+    }
+    fclose(arquivo);
+    return 0;
+}
+
+
+void inicializarCaso(Caso *caso) {
+    inicializarArena(&caso->arena, 0);
+    caso->erro = NULL;
+    caso->tamErro = 0;
+    inicializarPistasESuspeitos(caso);
+    inicializarMansao(caso);
+}
+
+// Deixa o caso pronto para ser só lido. As partidas buscam por texto apenas os
+// suspeitos (na acusação); numa tabela adotada esse índice ficaria para a primeira
+// busca, o que seria uma escrita no caso compartilhado.
+void prepararCaso(Caso *caso) {
+    indexarTabela(&caso->suspeitos);
+}
+
+void liberarCaso(Caso *caso) {
+    liberarMansao(caso);
+    liberarArena(&caso->arena);
+}
+
+// Começa uma partida sobre um caso já preparado. A arena da partida segue o modo
+// da arena do caso (usado no benchmark de memória).
+void inicializarJogo(Jogo *jogo, const Caso *caso) {
+    jogo->caso = caso;
+    inicializarArena(&jogo->arena, caso->arena.avulsa);
+    size_t palavras = (numSalas(caso) + 63) / 64;
+    jogo->pistaColetada = (uint64_t*) arenaAlocar(&jogo->arena, palavras * sizeof(uint64_t), 8);
+    memset(jogo->pistaColetada, 0, palavras * sizeof(uint64_t));
+    jogo->casoExclusivo = NULL;
+    inicializarPistasPendentes(jogo);
+    inicializarEvidencias(jogo);
+}
+
+void liberarJogo(Jogo *jogo) {
+    liberarArena(&jogo->arena);
+}
+
+
+// --- 10. BENCHMARKS (MODO LINHA DE COMANDO) ---
+
+static double agoraSegundos() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Hash original (sdbm, um byte por passo), mantido só para comparação.
+static unsigned int hashOriginal(const char *chave) {
+    unsigned long int hash = 0;
+    int c;
+    while ((c = *chave++)) {
+        hash = c + (hash << 6) + (hash << 16) - hash;
+    }
+    return (unsigned int) hash;
+}
+
+// Tabela encadeada original (101 posições fixas), mantida só para comparação.
+#define HASH_SIZE_ENCADEADA 101
+
+typedef struct ItemEncadeado {
+    char chave[100];
+    char valor[50];
+    struct ItemEncadeado *proximo;
+} ItemEncadeado;
+
+static ItemEncadeado* tabelaEncadeada[HASH_SIZE_ENCADEADA];
+
+static void inserirNaEncadeada(const char *chave, const char *valor) {
+    ItemEncadeado *novoItem = (ItemEncadeado*) malloc(sizeof(ItemEncadeado));
+    strcpy(novoItem->chave, chave);
+    strcpy(novoItem->valor, valor);
+    unsigned int indice = hashOriginal(chave) % HASH_SIZE_ENCADEADA;
+    novoItem->proximo = tabelaEncadeada[indice];
+    tabelaEncadeada[indice] = novoItem;
+}
+
+static char* encontrarNaEncadeada(const char *chave) {
+    ItemEncadeado *item = tabelaEncadeada[hashOriginal(chave) % HASH_SIZE_ENCADEADA];
+    while (item != NULL) {
+        if (strcmp(item->chave, chave) == 0) return item->valor;
+        item = item->proximo;
+    }
+    return NULL;
+}
+
+static void liberarEncadeada() {
+    for (int i = 0; i < HASH_SIZE_ENCADEADA; i++) {
+        ItemEncadeado *item = tabelaEncadeada[i];
+        while (item != NULL) {
+            ItemEncadeado *temp = item;
+            item = item->proximo;
+            free(temp);
+        }
+        tabelaEncadeada[i] = NULL;
+    }
+}
+
+static const char* SUSPEITOS_BENCH[] = {"Mordomo", "Jardineiro", "Governanta", "Dama_de_Companhia"};
+
+static void gerarPistaSintetica(char *destino, size_t tam, int i) {
+    snprintf(destino, tam, "Pista %d: um objeto suspeito encontrado no comodo %d.", i, (i * 7919) % 100003);
+}
+
+// Compara a vazão de consultas entre a tabela encadeada original e a tabela Robin Hood.
+void benchmarkHash(int n) {
+    Caso caso;
+    char (*amostras)[100] = (char(*)[100]) malloc((size_t) n * sizeof(*amostras));
+    for (int i = 0; i < n; i++) gerarPistaSintetica(amostras[i], sizeof(amostras[i]), i);
+
+    printf("Benchmark da tabela hash com %d pistas\n", n);
+
+    double t0 = agoraSegundos();
+    for (int i = 0; i < n; i++) inserirNaEncadeada(amostras[i], SUSPEITOS_BENCH[i % 4]);
+    double t1 = agoraSegundos();
+    int encontrados = 0;
+    for (int i = 0; i < n; i++) encontrados += encontrarNaEncadeada(amostras[i]) != NULL;
+    double t2 = agoraSegundos();
+    printf("Encadeada (101):  insercao %.3f s | %d consultas em %.3f s (%.0f consultas/s)\n",
+           t1 - t0, encontrados, t2 - t1, n / (t2 - t1));
+    liberarEncadeada();
+
+    inicializarArena(&caso.arena, 0);
+    inicializarPistasESuspeitos(&caso);
+    t0 = agoraSegundos();
+    for (int i = 0; i < n; i++) inserirNaHash(&caso, amostras[i], SUSPEITOS_BENCH[i % 4]);
+    t1 = agoraSegundos();
+    encontrados = 0;
+    for (int i = 0; i < n; i++) encontrados += encontrarSuspeito(&caso, amostras[i]) != NULL;
+    t2 = agoraSegundos();
+    printf("Robin Hood (%u): insercao %.3f s | %d consultas em %.3f s (%.0f consultas/s)\n",
+           caso.pistas.capacidade, t1 - t0, encontrados, t2 - t1, n / (t2 - t1));
+    liberarArena(&caso.arena);
+
+    free(amostras);
+}
+
+static void contarVisita(NoPista* no, void* contexto) {
+    (void) no;
+    (*(long*) contexto)++;
+}
+
+// Frases usadas para montar pistas longas no benchmark da função hash.
+static const char* FRASES_BENCH[] = {
+    "Um livro sobre venenos estava fora do lugar. ", "Um frasco quebrado com um liquido suspeito. ",
+    "Uma carta de ameaca enderecada a vitima. ", "Pegadas de botas sujas de terra. ",
+    "Uma faca afiada desapareceu do conjunto. ", "Um recibo de compra de luvas de couro. ",
+    "Ha marcas de cera de vela no tapete. ", "O relogio da parede parou as onze e quinze. "
+};
+
+static unsigned int primoAPartirDe(unsigned int n) {
+    for (;; n++) {
+        int primo = n > 1;
+        for (unsigned int d = 2; primo && d * d <= n; d++) primo = n % d != 0;
+        if (primo) return n;
+    }
+}
+
+// Vazão e distribuição nas posições de uma tabela com o tamanho que a TabelaStrings
+// usaria para esses textos: sdbm reduzido por primo (como era), sdbm reduzido por
+// máscara e a função atual por máscara.
+static void avaliarFuncoesHash(const char *nomeCorpus, const TabelaStrings *corpus) {
+    unsigned int n = corpus->quantidade - 1;
+    unsigned int posicoes = HASH_CAPACIDADE_INICIAL;
+    while ((unsigned long long) n * HASH_CARGA_DEN > (unsigned long long) posicoes * HASH_CARGA_NUM) posicoes *= 2;
+    unsigned int primo = primoAPartirDe(posicoes);
+    size_t bytes = corpus->usoTextos - 1 - n;
+    int repeticoes = (int) (200000000 / (bytes + 1)) + 1;
+    unsigned int *contagem = (unsigned int*) malloc((size_t) primo * sizeof(unsigned int));
+    double esperado = 100.0 * exp(-(double) n / posicoes);
+
+    printf("\n%s: %u textos, media de %.1f bytes, %u posicoes (%u para o primo)\n",
+           nomeCorpus, n, (double) bytes / n, posicoes, primo);
+    printf("  %-18s %8s %9s %7s %9s\n", "funcao", "GB/s", "vazias%", "maior", "chi2/gl");
+    const char *nomes[3] = {"sdbm % primo", "sdbm & mascara", "wyhash & mascara"};
+    for (int f = 0; f < 3; f++) {
+        volatile uint64_t sorvedouro = 0;
+        uint64_t acumulado = 0;
+        double t0 = agoraSegundos();
+        for (int r = 0; r < repeticoes; r++) {
+            for (IdTexto id = 1; id <= n; id++) {
+                if (f < 2) acumulado += hashOriginal(textoDoId(corpus, id));
+                else acumulado += funcaoHash(textoDoId(corpus, id), tamanhoDoId(corpus, id));
+            }
+        }
+        double t1 = agoraSegundos();
+        sorvedouro = acumulado;
+        (void) sorvedouro;
+
+        unsigned int m = f == 0 ? primo : posicoes;
+        memset(contagem, 0, (size_t) m * sizeof(unsigned int));
+        for (IdTexto id = 1; id <= n; id++) {
+            const char *texto = textoDoId(corpus, id);
+            if (f == 0) contagem[hashOriginal(texto) % primo]++;
+            else if (f == 1) contagem[hashOriginal(texto) & (posicoes - 1)]++;
+            else contagem[(unsigned int) funcaoHash(texto, tamanhoDoId(corpus, id)) & (posicoes - 1)]++;
+        }
+        // Qui-quadrado por grau de liberdade: perto de 1 para uma função uniforme.
+        unsigned int vazias = 0, maior = 0;
+        double media = (double) n / m, chi2 = 0;
+        for (unsigned int i = 0; i < m; i++) {
+            vazias += contagem[i] == 0;
+            if (contagem[i] > maior) maior = contagem[i];
+            chi2 += (contagem[i] - media) * (contagem[i] - media) / media;
+        }
+        printf("  %-18s %8.2f %9.1f %7u %9.3f\n", nomes[f], (double) bytes * repeticoes / (t1 - t0) / 1e9,
+               100.0 * vazias / m, maior, chi2 / (m - 1));
+    }
+    printf("  (uniforme: ~%.1f%% de posicoes vazias)\n", esperado);
+    free(contagem);
+}
+
+// Compara a função hash original (sdbm) com a atual em textos parecidos com os do jogo.
+void benchmarkFuncaoHash(int n, const char *mapa) {
+    Arena arena;
+    TabelaStrings corpus;
+    char texto[512];
+    inicializarArena(&arena, 0);
+
+    const char *nomesCorpus[4] = {"Nomes de sala", "Pistas sinteticas", "Pistas de mapa gerado", "Pistas longas"};
+    for (int tipo = 0; tipo < 4; tipo++) {
+        inicializarTabelaStrings(&corpus, &arena);
+        unsigned int semente = 99;
+        for (int i = 0; i < n; i++) {
+            if (tipo == 0) {
+                snprintf(texto, sizeof(texto), "Sala %d", i);
+            } else if (tipo == 1) {
+                gerarPistaSintetica(texto, sizeof(texto), i);
+            } else if (tipo == 2) {
+                snprintf(texto, sizeof(texto), "Pista %d: um vestigio deixado na sala %d.", i, i);
+            } else {
+                int usado = snprintf(texto, sizeof(texto), "Pista %d: ", i);
+                for (int k = 0; k < 4; k++) {
+                    semente = semente * 1103515245u + 12345u;
+                    usado += snprintf(texto + usado, sizeof(texto) - usado, "%s", FRASES_BENCH[(semente >> 16) % 8]);
+                }
+            }
+            internarTexto(&corpus, texto);
+        }
+        avaliarFuncoesHash(nomesCorpus[tipo], &corpus);
+    }
+    liberarArena(&arena);
+
+    if (mapa != NULL) {
+        Caso caso;
+        inicializarCaso(&caso);
+        if (carregarMapa(&caso, mapa) == 0) {
+            avaliarFuncoesHash("Pistas do mapa", &caso.pistas);
+            avaliarFuncoesHash("Nomes das salas do mapa", &caso.mansao.nomes);
+        }
+        liberarCaso(&caso);
+    }
+}
+
+// Inserção e percurso em ordem na árvore de pistas para fluxos ordenados,
+// invertidos e aleatórios, de 10^4 até 'maximo' pistas.
+void benchmarkPistas(int maximo) {
+    Caso caso;
+    Jogo partida;
+    Jogo *jogo = &partida;
+    const char* nomesOrdem[] = {"ordenada", "invertida", "aleatoria"};
+    printf("%-10s %-10s %12s %12s %10s %8s\n", "n", "ordem", "insercao(s)", "percurso(s)", "visitados", "altura");
+    for (int n = 10000; n > 0 && n <= maximo; n *= 10) {
+        int *ordem = (int*) malloc((size_t) n * sizeof(int));
+        char pista[100];
+        for (int tipo = 0; tipo < 3; tipo++) {
+            inicializarCaso(&caso);
+            for (int i = 0; i < n; i++) ordem[i] = tipo == 1 ? n - 1 - i : i;
+            if (tipo == 2) {
+                unsigned int semente = 12345;
+                for (int i = n - 1; i > 0; i--) {
+                    semente = semente * 1103515245u + 12345u;
+                    int j = (int) ((semente >> 8) % (unsigned int) (i + 1));
+                    int temp = ordem[i]; ordem[i] = ordem[j]; ordem[j] = temp;
+                }
+            }
+            // Zeros à esquerda fazem a ordem numérica coincidir com a de strcmp.
+            IdTexto *ids = (IdTexto*) malloc((size_t) n * sizeof(IdTexto));
+            for (int i = 0; i < n; i++) {
+                snprintf(pista, sizeof(pista), "Pista %09d", ordem[i]);
+                ids[i] = internarTexto(&caso.pistas, pista);
+            }
+            inicializarJogo(jogo, &caso);
+            NoPista* raiz = NULL;
+            double t0 = agoraSegundos();
+            for (int i = 0; i < n; i++) raiz = inserirPista(jogo, raiz, ids[i], NULL);
+            double t1 = agoraSegundos();
+            long visitados = 0;
+            percorrerPistas(raiz, contarVisita, &visitados);
+            double t2 = agoraSegundos();
+            printf("%-10d %-10s %12.3f %12.3f %10ld %8d\n", n, nomesOrdem[tipo], t1 - t0, t2 - t1, visitados, alturaPista(raiz));
+            free(ids);
+            liberarJogo(jogo);
+            liberarCaso(&caso);
+        }
+        free(ordem);
+    }
+}
+
+// Tempo para deixar um mapa pronto para jogar (para o compilado, basicamente o mmap).
+void benchmarkCarga(Caso *caso, const char *caminho) {
+    double t0 = agoraSegundos();
+    int erro = carregarMapa(caso, caminho);
+    double t1 = agoraSegundos();
+    if (erro) return;
+    printf("%s: %u salas, %u pistas, %u suspeitos carregados em %.3f ms (%s)\n", caminho,
+           numSalas(caso) - 1, caso->pistas.quantidade - 1, caso->suspeitos.quantidade - 1, (t1 - t0) * 1000,
+           caso->mansao.mapa ? "compilado, mapeado em memoria" : "texto");
+}
+
+// Busca em largura a partir de 'origem' (pelos dois caminhos e pela volta) até a
+// primeira sala com pista pendente: a resposta ingênua, O(n) por consulta.
+// 'visita' guarda a última consulta que passou por cada sala, para não precisar zerá-la.
+static unsigned int pistaMaisProximaIngenua(const Jogo *jogo, unsigned int origem, unsigned int *fila,
+                                            unsigned int *nivel, unsigned int *visita, unsigned int consulta) {
+    const Mansao *m = &jogo->caso->mansao;
+    unsigned int inicio = 0, fim = 0;
+    fila[fim++] = origem;
+    nivel[origem] = 0;
+    visita[origem] = consulta;
+    while (inicio < fim) {
+        unsigned int sala = fila[inicio++];
+        if (m->salas[sala].pista != SEM_TEXTO && !(jogo->pistaColetada[sala / 64] & (1ull << (sala % 64)))) {
+            return nivel[sala];
+        }
+        unsigned int vizinhas[3] = {m->salas[sala].esquerda, m->salas[sala].direita, m->pai[sala]};
+        for (int i = 0; i < 3; i++) {
+            unsigned int v = vizinhas[i];
+            if (v != SEM_TEXTO && m->entrada[v] != NAO_ALCANCADA && visita[v] != consulta
+                && (i == 2 || m->pai[v] == sala)) {
+                visita[v] = consulta;
+                nivel[v] = nivel[sala] + 1;
+                fila[fim++] = v;
+            }
+        }
+    }
+    return NAO_ALCANCADA;
+}
+
+static unsigned int sortearSala(const Mansao *m, unsigned int *semente) {
+    *semente = *semente * 1103515245u + 12345u;
+    return m->ordem[(*semente >> 4) % m->numAlcancadas];
+}
+
+// Monta a navegação, recolhe quase todas as pistas (fica uma em cada 256) e mede as três consultas em salas
+// sorteadas. A pista mais próxima é conferida com a busca em largura ingênua (só
+// nas primeiras 'conferidas' consultas, que custam O(n) cada), e cada rota com a distância.
+void benchmarkNavegacao(Caso *caso, int consultas) {
+    if (consultas < 1) consultas = 1;
+    double t0 = agoraSegundos();
+    prepararNavegacao(caso);
+    prepararPistaMaisProxima(caso);
+    double t1 = agoraSegundos();
+    const Mansao *m = &caso->mansao;
+    printf("Navegacao: %u salas alcancaveis, montada em %.3f s\n", m->numAlcancadas, t1 - t0);
+
+    Jogo partida;
+    Jogo *jogo = &partida;
+    inicializarJogo(jogo, caso);
+    NoPista* arvore = NULL;
+    unsigned int semente = 2024;
+    for (unsigned int p = 0; p < m->numAlcancadas; p++) {
+        semente = semente * 1103515245u + 12345u;
+        if ((semente >> 16) % 256 != 0) coletarPista(jogo, m->ordem[p], &arvore);
+    }
+
+    unsigned int total = numSalas(caso);
+    unsigned int *origens = (unsigned int*) malloc((size_t) consultas * sizeof(unsigned int));
+    unsigned int *destinos = (unsigned int*) malloc((size_t) consultas * sizeof(unsigned int));
+    for (int i = 0; i < consultas; i++) {
+        origens[i] = sortearSala(m, &semente);
+        destinos[i] = sortearSala(m, &semente);
+    }
+
+    long divergencias = 0, soma = 0;
+    unsigned int *resposta = (unsigned int*) malloc((size_t) consultas * sizeof(unsigned int));
+    t0 = agoraSegundos();
+    for (int i = 0; i < consultas; i++) pistaMaisProxima(jogo, origens[i], &resposta[i]);
+    t1 = agoraSegundos();
+    printf("  pista mais proxima: %.2f us/consulta\n", (t1 - t0) * 1e6 / consultas);
+
+    int conferidas = consultas < 200 ? consultas : 200;
+    unsigned int *fila = (unsigned int*) malloc(total * sizeof(unsigned int));
+    unsigned int *nivel = (unsigned int*) malloc(total * sizeof(unsigned int));
+    unsigned int *visita = (unsigned int*) calloc(total, sizeof(unsigned int));
+    t0 = agoraSegundos();
+    for (int i = 0; i < conferidas; i++) {
+        divergencias += pistaMaisProximaIngenua(jogo, origens[i], fila, nivel, visita, (unsigned int) i + 1) != resposta[i];
+    }
+    t1 = agoraSegundos();
+    printf("  busca em largura:   %.2f us/consulta (%d conferidas, %ld divergencias)\n",
+           (t1 - t0) * 1e6 / conferidas, conferidas, divergencias);
+
+    size_t capPassos = 1024;
+    char *passos = (char*) malloc(capPassos);
+    divergencias = 0;
+    t0 = agoraSegundos();
+    for (int i = 0; i < consultas; i++) {
+        int n = rotaEntreSalas(caso, origens[i], destinos[i], passos, capPassos);
+        if (n < 0) {
+            capPassos = (size_t) distanciaEntreSalas(caso, origens[i], destinos[i]) + 1;
+            passos = (char*) realloc(passos, capPassos);
+            n = rotaEntreSalas(caso, origens[i], destinos[i], passos, capPassos);
+        }
+        // Refaz a rota a pé e confere se ela termina no destino.
+        unsigned int sala = origens[i];
+        for (int j = 0; j < n; j++) {
+            sala = passos[j] == 'v' ? m->pai[sala] : passos[j] == 'e' ? m->salas[sala].esquerda : m->salas[sala].direita;
+        }
+        divergencias += sala != destinos[i];
+        soma += n;
+    }
+    t1 = agoraSegundos();
+    printf("  rota entre salas:   %.2f us/consulta (media de %.1f passos, %ld divergencias)\n",
+           (t1 - t0) * 1e6 / consultas, (double) soma / consultas, divergencias);
+
+    unsigned int lista[100];
+    soma = 0;
+    t0 = agoraSegundos();
+    for (int i = 0; i < consultas; i++) soma += salasComPistaNaSubarvore(jogo, origens[i], lista, 100);
+    t1 = agoraSegundos();
+    printf("  pistas na subarvore (ate 100): %.2f us/consulta (media de %.1f salas)\n",
+           (t1 - t0) * 1e6 / consultas, (double) soma / consultas);
+
+    free(passos);
+    free(fila);
+    free(nivel);
+    free(visita);
+    free(resposta);
+    free(origens);
+    free(destinos);
+    liberarJogo(jogo);
+}
+
+// Pico de memória residente do processo, em KiB (-1 se indisponível).
+static long picoMemoriaKiB() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return (long) (pmc.PeakWorkingSetSize / 1024);
+    return -1;
+#else
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) return -1;
+#if defined(__APPLE__)
+    return uso.ru_maxrss / 1024; // macOS informa em bytes
+#else
+    return uso.ru_maxrss;
+#endif
+#endif
+}
+
+// Monta uma mansão completa de n salas, associa uma pista a cada sala, coleta
+// todas e libera tudo. Com 'avulsa' = 1, cada pedido à arena é um malloc próprio,
+// como antes dela. Rode cada modo num processo separado para comparar o pico de memória.
+void benchmarkMemoria(int n, int avulsa) {
+    Caso caso;
+    Jogo partida;
+    Jogo *jogo = &partida;
+    char nome[50], pista[100];
+    inicializarArena(&caso.arena, avulsa);
+    inicializarPistasESuspeitos(&caso);
+    inicializarMansao(&caso);
+
+    double t0 = agoraSegundos();
+    for (int i = 1; i <= n; i++) {
+        snprintf(nome, sizeof(nome), "Sala %d", i);
+        snprintf(pista, sizeof(pista), "Pista deixada na sala %d", i);
+        unsigned int sala = criarSala(&caso, nome, pista);
+        inserirNaHash(&caso, pista, SUSPEITOS_BENCH[i % 4]);
+        if (i > 1) {
+            Sala* pai = &caso.mansao.salas[i / 2];
+            if (i % 2 == 0) pai->esquerda = sala;
+            else pai->direita = sala;
+        }
+    }
+    inicializarJogo(jogo, &caso);
+    NoPista* arvore = NULL;
+    for (unsigned int i = SALA_INICIAL; i < numSalas(&caso); i++) arvore = inserirPista(jogo, arvore, caso.mansao.salas[i].pista, NULL);
+    double t1 = agoraSegundos();
+    size_t pedidos = caso.arena.numPedidos + jogo->arena.numPedidos;
+    size_t mallocs = caso.arena.numMallocs + jogo->arena.numMallocs;
+    liberarJogo(jogo);
+    liberarCaso(&caso);
+    double t2 = agoraSegundos();
+
+    printf("Modo %s, %d salas\n", avulsa ? "malloc por no" : "arena", n);
+    printf("  pedidos de memoria: %zu | chamadas a malloc: %zu\n", pedidos, mallocs);
+    printf("  montagem: %.3f s | liberacao: %.3f s\n", t1 - t0, t2 - t1);
+    printf("  pico de memoria residente: %ld KiB\n", picoMemoriaKiB());
+}
+
+
+// --- 11. RESOLUÇÃO AUTOMÁTICA (SEM ENTRADA DO JOGADOR) ---
+
+// Texto de saída de um caso, montado em memória para que os casos resolvidos
+// em paralelo saiam inteiros e na ordem dos arquivos.
+typedef struct Relatorio {
+    char *texto;
+    size_t tamanho;
+    size_t capacidade;
+} Relatorio;
+
+static void escreverRelatorio(Relatorio *r, const char *formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    va_list copia;
+    va_copy(copia, args);
+    int n = vsnprintf(NULL, 0, formato, copia);
+    va_end(copia);
+    if (n > 0) {
+        if (r->tamanho + n + 1 > r->capacidade) {
+            size_t nova = r->capacidade ? r->capacidade : 256;
+            while (nova < r->tamanho + n + 1) nova *= 2;
+            r->texto = (char*) realloc(r->texto, nova);
+            r->capacidade = nova;
+        }
+        vsnprintf(r->texto + r->tamanho, (size_t) n + 1, formato, args);
+        r->tamanho += n;
+    }
+    va_end(args);
+}
+
+// Percorre a mansão a partir da entrada recolhendo as pistas. Com 'roteiro' (uma
+// sequência de 'e' e 'd'; outros caracteres e caminhos inexistentes são ignorados)
+// segue só esse caminho; sem roteiro, visita todas as salas alcançáveis.
+// Devolve quantas salas foram visitadas.
+unsigned int resolverCaso(Jogo *jogo, const char *roteiro, NoPista** raizPistas) {
+    unsigned int visitadas = 1;
+    if (roteiro != NULL) {
+        unsigned int atual = SALA_INICIAL;
+        coletarPista(jogo, atual, raizPistas);
+        for (const char *c = roteiro; *c; c++) {
+            char passo = tolower(*c);
+            unsigned int proxima = SEM_TEXTO;
+            if (passo == 'e') proxima = jogo->caso->mansao.salas[atual].esquerda;
+            else if (passo == 'd') proxima = jogo->caso->mansao.salas[atual].direita;
+            if (proxima == SEM_TEXTO) continue;
+            atual = proxima;
+            coletarPista(jogo, atual, raizPistas);
+            visitadas++;
+        }
+        return visitadas;
+    }
+
+    // Busca em profundidade com pilha explícita: um mapa pode ser um corredor de
+    // milhões de salas. Como uma sala pode ser citada por mais de um caminho, cada
+    // uma é marcada para não ser visitada duas vezes.
+    unsigned int total = numSalas(jogo->caso);
+    unsigned char *marcada = (unsigned char*) calloc(total, 1);
+    unsigned int *pilha = (unsigned int*) malloc(total * sizeof(unsigned int));
+    unsigned int topo = 0;
+    pilha[topo++] = SALA_INICIAL;
+    marcada[SALA_INICIAL] = 1;
+    visitadas = 0;
+    while (topo > 0) {
+        unsigned int atual = pilha[--topo];
+        coletarPista(jogo, atual, raizPistas);
+        visitadas++;
+        unsigned int saidas[2] = {jogo->caso->mansao.salas[atual].direita, jogo->caso->mansao.salas[atual].esquerda};
+        for (int i = 0; i < 2; i++) {
+            if (saidas[i] != SEM_TEXTO && saidas[i] < total && !marcada[saidas[i]]) {
+                marcada[saidas[i]] = 1;
+                pilha[topo++] = saidas[i];
+            }
+        }
+    }
+    free(pilha);
+    free(marcada);
+    return visitadas;
+}
+
+// Veredito para cada suspeito: CULPADO com 2 ou mais pistas contra ele, a mesma
+// regra do julgamento interativo.
+void relatarVeredito(Jogo *jogo, unsigned int visitadas, Relatorio *r) {
+    unsigned int max = jogo->caso->suspeitos.quantidade;
+    IdTexto *ranking = (IdTexto*) malloc(max * sizeof(IdTexto));
+    int total = listarRankingSuspeitos(jogo, ranking, (int) max);
+    escreverRelatorio(r, "  salas visitadas: %u\n", visitadas);
+    for (int i = 0; i < total; i++) {
+        int n = evidenciasContra(jogo, ranking[i]);
+        escreverRelatorio(r, "  %-20s %d %s\n", textoDoId(&jogo->caso->suspeitos, ranking[i]), n, n >= 2 ? "CULPADO" : "INOCENTE");
+    }
+    free(ranking);
+}
+
+// Resolve um arquivo de caso com um caso e uma partida só seus. Devolve 0 se o mapa carregou.
+// Um mapa que não carrega vira uma linha de ERRO no relatório, junto dos outros
+// resultados do caso, e não uma mensagem solta em stderr.
+int resolverArquivo(const char *caminho, const char *roteiro, Relatorio *r) {
+    Caso caso;
+    char motivo[256] = "mapa invalido";
+    inicializarCaso(&caso);
+    caso.erro = motivo;
+    caso.tamErro = sizeof(motivo);
+    escreverRelatorio(r, "%s\n", caminho);
+    int erro = carregarMapa(&caso, caminho);
+    if (erro) {
+        escreverRelatorio(r, "  ERRO: %s\n", motivo);
+    } else {
+        prepararCaso(&caso);
+        Jogo partida;
+        Jogo *jogo = &partida;
+        inicializarJogo(jogo, &caso);
+        NoPista* arvoreDePistas = NULL;
+        unsigned int visitadas = resolverCaso(jogo, roteiro, &arvoreDePistas);
+        relatarVeredito(jogo, visitadas, r);
+        liberarJogo(jogo);
+    }
+    liberarCaso(&caso);
+    return erro;
+}
+
+// Resolve todos os arquivos de 'diretorio' (em ordem de nome) repartidos entre
+// 'numThreads' threads. Cada thread pega o próximo caso de um contador atômico.
+int resolverLote(const char *diretorio, int numThreads, const char *roteiro) {
+    std::vector<std::string> casos;
+    std::error_code falha;
+    for (std::filesystem::directory_iterator it(diretorio, falha), fim; !falha && it != fim; it.increment(falha)) {
+        // Links quebrados e entradas ilegíveis são pulados, sem derrubar o lote.
+        std::error_code erroEntrada;
+        if (it->is_regular_file(erroEntrada) && !erroEntrada) casos.push_back(it->path().string());
+    }
+    if (falha) {
+        fprintf(stderr, "Nao foi possivel listar %s.\n", diretorio);
+        return 1;
+    }
+    std::sort(casos.begin(), casos.end());
+    if (numThreads < 1) numThreads = 1;
+
+    std::vector<Relatorio> relatorios(casos.size());
+    std::atomic<size_t> proximo(0);
+    std::atomic<int> erros(0);
+    double t0 = agoraSegundos();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&]() {
+            for (size_t i = proximo++; i < casos.size(); i = proximo++) {
+                if (resolverArquivo(casos[i].c_str(), roteiro, &relatorios[i]) != 0) erros++;
+            }
+        });
+    }
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+    double t1 = agoraSegundos();
+
+    for (size_t i = 0; i < relatorios.size(); i++) {
+        fwrite(relatorios[i].texto, 1, relatorios[i].tamanho, stdout);
+        free(relatorios[i].texto);
+    }
+    fprintf(stderr, "%zu casos (%d com erro) em %.3f s com %d threads (%.0f casos/s)\n",
+            casos.size(), erros.load(), t1 - t0, numThreads, casos.size() / (t1 - t0));
+    return erros.load() != 0;
+}
+
+// Teste de carga do caso compartilhado: com 1, 2, 4... até 'maxThreads' threads,
+// cada thread joga 'partidas' partidas completas (todas as salas) sobre o mesmo
+// caso, sem nenhuma trava. Toda partida deve chegar às contagens da partida de
+// referência, e a vazão deve crescer na proporção do número de threads.
+int benchmarkSessoes(const Caso *caso, int maxThreads, int partidas) {
+    unsigned int numSuspeitos = caso->suspeitos.quantidade;
+    int *referencia = (int*) calloc(numSuspeitos, sizeof(int));
+    Jogo primeira;
+    NoPista* raiz = NULL;
+    inicializarJogo(&primeira, caso);
+    unsigned int visitadas = resolverCaso(&primeira, NULL, &raiz);
+    for (IdTexto s = 1; s < numSuspeitos; s++) referencia[s] = evidenciasContra(&primeira, s);
+    liberarJogo(&primeira);
+
+    printf("%u salas por partida, %d partidas por thread\n", visitadas, partidas);
+    printf("%-8s %12s %12s %10s %12s\n", "threads", "tempo(s)", "partidas/s", "aceleracao", "divergencias");
+    std::atomic<int> divergencias(0);
+    double vazaoBase = 0;
+    for (int numThreads = 1; ; numThreads = numThreads * 2 < maxThreads ? numThreads * 2 : maxThreads) {
+        int divergenciasAntes = divergencias.load();
+        std::vector<std::thread> threads;
+        double t0 = agoraSegundos();
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([&]() {
+                for (int p = 0; p < partidas; p++) {
+                    Jogo jogo;
+                    NoPista* arvore = NULL;
+                    inicializarJogo(&jogo, caso);
+                    resolverCaso(&jogo, NULL, &arvore);
+                    for (IdTexto s = 1; s < numSuspeitos; s++) {
+                        if (evidenciasContra(&jogo, s) != referencia[s]) {
+                            divergencias++;
+                            break;
+                        }
+                    }
+                    liberarJogo(&jogo);
+                }
+            });
+        }
+        for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+        double t1 = agoraSegundos();
+        double vazao = (double) numThreads * partidas / (t1 - t0);
+        if (numThreads == 1) vazaoBase = vazao;
+        printf("%-8d %12.3f %12.0f %9.2fx %12d\n", numThreads, t1 - t0, vazao, vazao / vazaoBase,
+               divergencias.load() - divergenciasAntes);
+        if (numThreads == maxThreads) break;
+    }
+    free(referencia);
+    return divergencias.load() != 0;
+}
+
+
+// --- 12. LÓGICA PRINCIPAL DO JOGO ---
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench-hash") == 0) {
+        benchmarkHash(argc > 2 ? atoi(argv[2]) : 100000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-funcao-hash") == 0) {
+        benchmarkFuncaoHash(argc > 2 ? atoi(argv[2]) : 100000, argc > 3 ? argv[3] : NULL);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-pistas") == 0) {
+        benchmarkPistas(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-memoria") == 0) {
+        benchmarkMemoria(argc > 2 ? atoi(argv[2]) : 1000000, argc > 3 && strcmp(argv[3], "avulsa") == 0);
+        return 0;
+    }
+
+    if (argc > 3 && strcmp(argv[1], "--gerar-mapa") == 0) {
+        return gerarMapa((unsigned int) strtoul(argv[2], NULL, 10), argv[3]);
+    }
+    if (argc > 2 && strcmp(argv[1], "--resolver") == 0) {
+        Relatorio r = {NULL, 0, 0};
+        int erro = resolverArquivo(argv[2], argc > 3 ? argv[3] : NULL, &r);
+        fwrite(r.texto, 1, r.tamanho, stdout);
+        free(r.texto);
+        return erro;
+    }
+    if (argc > 2 && strcmp(argv[1], "--lote") == 0) {
+        int threads = argc > 3 ? atoi(argv[3]) : (int) std::thread::hardware_concurrency();
+        return resolverLote(argv[2], threads, argc > 4 ? argv[4] : NULL);
+    }
+
+    Caso caso;
+    inicializarCaso(&caso);
+    if (argc > 3 && strcmp(argv[1], "--compilar-mapa") == 0) {
+        int erro = carregarMapa(&caso, argv[2]) || compilarMapa(&caso, argv[3]);
+        if (!erro) printf("%s compilado em %s (%u salas, %u pistas).\n", argv[2], argv[3], numSalas(&caso) - 1, caso.pistas.quantidade - 1);
+        liberarCaso(&caso);
+        return erro;
+    }
+    if (argc > 2 && strcmp(argv[1], "--bench-carga") == 0) {
+        benchmarkCarga(&caso, argv[2]);
+        liberarCaso(&caso);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--bench-navegacao") == 0) {
+        int erro = carregarMapa(&caso, argv[2]);
+        if (!erro) {
+            prepararCaso(&caso);
+            benchmarkNavegacao(&caso, argc > 3 ? atoi(argv[3]) : 100000);
+        }
+        liberarCaso(&caso);
+        return erro;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-sessoes") == 0) {
+        int threads = argc > 2 ? atoi(argv[2]) : (int) std::thread::hardware_concurrency();
+        int partidas = argc > 3 ? atoi(argv[3]) : 10000;
+        int erro = carregarCaso(&caso, argc > 4 ? argv[4] : NULL);
+        if (!erro) {
+            prepararCaso(&caso);
+            erro = benchmarkSessoes(&caso, threads > 0 ? threads : 1, partidas);
+        }
+        liberarCaso(&caso);
+        return erro;
+    }
+
+    // Montando o mapa da mansão (de um arquivo ou o caso padrão)
+    if (carregarCaso(&caso, argc > 1 ? argv[1] : NULL)) {
+        liberarCaso(&caso);
+        return 1;
+    }
+    prepararCaso(&caso);
+    prepararNavegacao(&caso);
+    Jogo partida;
+    Jogo *jogo = &partida;
+    inicializarJogo(jogo, &caso);
+    jogo->casoExclusivo = &caso; // só esta partida usa o caso
+
+    // Início do Jogo
+    NoPista* arvoreDePistas = NULL;
+
+    printf("*****************************************\n");
+    printf("* DETECTIVE QUEST: O CASO FINAL         *\n");
+    printf("*****************************************\n");
+    printf("Explore os comodos, colete pistas e descubra o culpado.\n\n");
+
+    explorarSalas(jogo, SALA_INICIAL, &arvoreDePistas);
+    verificarSuspeitoFinal(jogo, arvoreDePistas);
+
+    // --- LIBERANDO TODA A MEMÓRIA ALOCADA ---
+    printf("\nLimpando a cena do crime (liberando memoria)...\n");
+    liberarJogo(jogo);
+    liberarCaso(&caso);
+    printf("Sistema finalizado.\n");
+
+    return 0;
+}
@@ -1,321 +1,2554 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-
-// Define a quantidade mxima de componentes que podem ser cadastrados.
-#define MAX_COMPONENTES 20
-
-// --- 1. Criao de Structs ---
-
-/**
- * @struct Componente
- * @brief Estrutura para armazenar os dados de um componente da torre.
- * Contm nome, tipo e um nvel de prioridade para a montagem.
- */
-typedef struct {
-    char nome[30];
-    char tipo[20];
-    int prioridade;
-} Componente;
-
-
-// --- Prottipos das Funes ---
-
-void limparBufferEntrada();
-void removerQuebraDeLinha(char *str);
-void cadastrarComponente(Componente componentes[], int *total);
-void mostrarComponentes(const Componente componentes[], int total);
-
-// Algoritmos de Ordenao
-void bubbleSortPorNome(Componente componentes[], int total, long long *comparacoes);
-void insertionSortPorTipo(Componente componentes[], int total, long long *comparacoes);
-void selectionSortPorPrioridade(Componente componentes[], int total, long long *comparacoes);
-
-// Algoritmos de Busca
-int buscaSequencialPorNome(const Componente componentes[], int total, const char *nomeBuscado, int *comparacoes);
-int buscaBinariaPorNome(const Componente componentes[], int total, const char *nomeBuscado, int *comparacoes);
-
-
-// --- Funo Principal ---
-
-int main() {
-    Componente torre[MAX_COMPONENTES];
-    int totalComponentes = 0;
-    int ordenadoPorNome = 0; // Flag para controlar se a busca binria pode ser usada
-    int opcao;
-
-    do {
-        printf("\n--- SISTEMA DE MONTAGEM DA TORRE DE RADIO ---\n");
-        printf("1. Cadastrar Componente\n");
-        printf("2. Listar Componentes Atuais\n");
-        printf("3. Ordenar por Nome (Bubble Sort)\n");
-        printf("4. Ordenar por Tipo (Insertion Sort)\n");
-        printf("5. Ordenar por Prioridade (Selection Sort)\n");
-        printf("6. Buscar Componente por Nome\n");
-        printf("0. Sair\n");
-        printf("---------------------------------------------\n");
-        printf("Escolha uma opcao: ");
-        scanf("%d", &opcao);
-        limparBufferEntrada();
-
-        // Variveis para medir desempenho
-        clock_t inicio, fim;
-        double tempo_execucao;
-        long long comparacoes = 0;
-
-        switch (opcao) {
-            case 1:
-                cadastrarComponente(torre, &totalComponentes);
-                ordenadoPorNome = 0; // Qualquer insero "desordena" o vetor
-                break;
-
-            case 2:
-                mostrarComponentes(torre, totalComponentes);
-                break;
-
-            case 3:
-                printf("\nOrdenando por NOME com Bubble Sort...\n");
-                inicio = clock();
-                bubbleSortPorNome(torre, totalComponentes, &comparacoes);
-                fim = clock();
-                tempo_execucao = ((double)(fim - inicio)) / CLOCKS_PER_SEC * 1000; // em milissegundos
-                printf("Ordenacao concluida!\n");
-                printf("=> Comparacoes realizadas: %lld\n", comparacoes);
-                printf("=> Tempo de execucao: %.4f ms\n", tempo_execucao);
-                mostrarComponentes(torre, totalComponentes);
-                ordenadoPorNome = 1; // Agora est ordenado por nome
-                break;
-
-            case 4:
-                printf("\nOrdenando por TIPO com Insertion Sort...\n");
-                inicio = clock();
-                insertionSortPorTipo(torre, totalComponentes, &comparacoes);
-                fim = clock();
-                tempo_execucao = ((double)(fim - inicio)) / CLOCKS_PER_SEC * 1000;
-                printf("Ordenacao concluida!\n");
-                printf("=> Comparacoes realizadas: %lld\n", comparacoes);
-                printf("=> Tempo de execucao: %.4f ms\n", tempo_execucao);
-                mostrarComponentes(torre, totalComponentes);
-                ordenadoPorNome = 0;
-                break;
-
-            case 5:
-                printf("\nOrdenando por PRIORIDADE com Selection Sort...\n");
-                inicio = clock();
-                selectionSortPorPrioridade(torre, totalComponentes, &comparacoes);
-                fim = clock();
-                tempo_execucao = ((double)(fim - inicio)) / CLOCKS_PER_SEC * 1000;
-                printf("Ordenacao concluida!\n");
-                printf("=> Comparacoes realizadas: %lld\n", comparacoes);
-                printf("=> Tempo de execucao: %.4f ms\n", tempo_execucao);
-                mostrarComponentes(torre, totalComponentes);
-                ordenadoPorNome = 0;
-                break;
-
-            case 6: {
-                char nomeBusca[30];
-                int comparacoesBusca = 0;
-                int indice;
-
-                printf("Digite o nome do componente a ser buscado: ");
-                fgets(nomeBusca, sizeof(nomeBusca), stdin);
-                removerQuebraDeLinha(nomeBusca);
-
-                // --- Busca Sequencial ---
-                printf("\n--- Realizando Busca Sequencial ---\n");
-                indice = buscaSequencialPorNome(torre, totalComponentes, nomeBusca, &comparacoesBusca);
-                if (indice != -1) {
-                    printf("Componente encontrado na posicao %d!\n", indice);
-                } else {
-                    printf("Componente nao encontrado.\n");
-                }
-                printf("=> Comparacoes realizadas: %d\n", comparacoesBusca);
-
-                // --- Busca Binria (se aplicvel) ---
-                if (ordenadoPorNome) {
-                    printf("\n--- Realizando Busca Binaria (vetor ordenado) ---\n");
-                    comparacoesBusca = 0;
-                    indice = buscaBinariaPorNome(torre, totalComponentes, nomeBusca, &comparacoesBusca);
-                    if (indice != -1) {
-                        printf("Componente encontrado na posicao %d!\n", indice);
-                    } else {
-                        printf("Componente nao encontrado.\n");
-                    }
-                    printf("=> Comparacoes realizadas: %d\n", comparacoesBusca);
-                } else {
-                    printf("\nAVISO: Busca Binaria nao pode ser executada. O vetor nao esta ordenado por nome.\n");
-                }
-                break;
-            }
-            
-            case 0:
-                printf("Encerrando sistema de montagem...\n");
-                break;
-
-            default:
-                printf("Opcao invalida. Tente novamente.\n");
-        }
-
-    } while (opcao != 0);
-
-    return 0;
-}
-
-
-// --- Implementao das Funes Auxiliares ---
-
-/**
- * @brief Limpa o buffer de entrada do teclado.
- * Essencial aps usar scanf para ler nmeros, antes de ler strings.
- */
-void limparBufferEntrada() {
-    int c;
-    while ((c = getchar()) != '\n' && c != EOF);
-}
-
-/**
- * @brief Remove o caractere de quebra de linha ('\n') do final de uma string lida com fgets.
- */
-void removerQuebraDeLinha(char *str) {
-    str[strcspn(str, "\n")] = 0;
-}
-
-/**
- * @brief Cadastra um novo componente no vetor.
- */
-void cadastrarComponente(Componente componentes[], int *total) {
-    if (*total >= MAX_COMPONENTES) {
-        printf("Nao ha mais espaco para novos componentes!\n");
-        return;
-    }
-    printf("\n--- Cadastro de Novo Componente ---\n");
-    printf("Nome: ");
-    fgets(componentes[*total].nome, sizeof(componentes[*total].nome), stdin);
-    removerQuebraDeLinha(componentes[*total].nome);
-
-    printf("Tipo (controle, suporte, propulsao): ");
-    fgets(componentes[*total].tipo, sizeof(componentes[*total].tipo), stdin);
-    removerQuebraDeLinha(componentes[*total].tipo);
-
-    printf("Prioridade (1 a 10): ");
-    scanf("%d", &componentes[*total].prioridade);
-    limparBufferEntrada();
-    
-    (*total)++;
-    printf("Componente cadastrado com sucesso!\n");
-}
-
-/**
- * @brief Exibe todos os componentes cadastrados de forma formatada.
- */
-void mostrarComponentes(const Componente componentes[], int total) {
-    if (total == 0) {
-        printf("\nNenhum componente cadastrado ainda.\n");
-        return;
-    }
-    printf("\n------------------- LISTA DE COMPONENTES -------------------\n");
-    printf("%-20s | %-15s | %s\n", "NOME", "TIPO", "PRIORIDADE");
-    printf("----------------------------------------------------------\n");
-    for (int i = 0; i < total; i++) {
-        printf("%-20s | %-15s | %d\n", componentes[i].nome, componentes[i].tipo, componentes[i].prioridade);
-    }
-    printf("----------------------------------------------------------\n");
-}
-
-
-// --- Implementao dos Algoritmos de Ordenao ---
-
-/**
- * @brief Ordena os componentes por NOME usando o algoritmo Bubble Sort.
- */
-void bubbleSortPorNome(Componente componentes[], int total, long long *comparacoes) {
-    *comparacoes = 0;
-    for (int i = 0; i < total - 1; i++) {
-        for (int j = 0; j < total - i - 1; j++) {
-            (*comparacoes)++;
-            if (strcmp(componentes[j].nome, componentes[j + 1].nome) > 0) {
-                Componente temp = componentes[j];
-                componentes[j] = componentes[j + 1];
-                componentes[j + 1] = temp;
-            }
-        }
-    }
-}
-
-/**
- * @brief Ordena os componentes por TIPO usando o algoritmo Insertion Sort.
- */
-void insertionSortPorTipo(Componente componentes[], int total, long long *comparacoes) {
-    *comparacoes = 0;
-    for (int i = 1; i < total; i++) {
-        Componente chave = componentes[i];
-        int j = i - 1;
-        while (j >= 0) {
-            (*comparacoes)++;
-            if (strcmp(chave.tipo, componentes[j].tipo) < 0) {
-                componentes[j + 1] = componentes[j];
-                j--;
-            } else {
-                break;
-            }
-        }
-        componentes[j + 1] = chave;
-    }
-}
-
-/**
- * @brief Ordena os componentes por PRIORIDADE usando o algoritmo Selection Sort.
- */
-void selectionSortPorPrioridade(Componente componentes[], int total, long long *comparacoes) {
-    *comparacoes = 0;
-    for (int i = 0; i < total - 1; i++) {
-        int indice_menor = i;
-        for (int j = i + 1; j < total; j++) {
-            (*comparacoes)++;
-            if (componentes[j].prioridade < componentes[indice_menor].prioridade) {
-                indice_menor = j;
-            }
-        }
-        if (indice_menor != i) {
-            Componente temp = componentes[i];
-            componentes[i] = componentes[indice_menor];
-            componentes[indice_menor] = temp;
-        }
-    }
-}
-
-
-// --- Implementao dos Algoritmos de Busca ---
-
-/**
- * @brief Busca um componente pelo nome de forma sequencial.
- */
-int buscaSequencialPorNome(const Componente componentes[], int total, const char *nomeBuscado, int *comparacoes) {
-    *comparacoes = 0;
-    for (int i = 0; i < total; i++) {
-        (*comparacoes)++;
-        if (strcmp(componentes[i].nome, nomeBuscado) == 0) {
-            return i; // Retorna o ndice onde encontrou
-        }
-    }
-    return -1; // Retorna -1 se no encontrou
-}
-
-/**
- * @brief Busca um componente pelo nome em um vetor ORDENADO.
- */
-int buscaBinariaPorNome(const Componente componentes[], int total, const char *nomeBuscado, int *comparacoes) {
-    *comparacoes = 0;
-    int esquerda = 0, direita = total - 1;
-    while (esquerda <= direita) {
-        (*comparacoes)++;
-        int meio = esquerda + (direita - esquerda) / 2;
-        int res = strcmp(nomeBuscado, componentes[meio].nome);
-
-        if (res == 0) return meio; // Encontrou
-        if (res > 0) esquerda = meio + 1; // Busca na metade direita
-        else direita = meio - 1; // Busca na metade esquerda
-    }
-    return -1; // No encontrou
-}
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Tela.h"
+
+// Capacidade inicial do inventário; ele dobra de tamanho sempre que enche.
+#define CAPACIDADE_INICIAL 16
+
+// Faixa válida de prioridade de um componente.
+#define PRIORIDADE_MINIMA 1
+#define PRIORIDADE_MAXIMA 10
+#define FAIXA_PRIORIDADE  (PRIORIDADE_MAXIMA - PRIORIDADE_MINIMA + 1)
+
+// Quantos componentes a listagem mostra antes de resumir o restante.
+#define LIMITE_LISTAGEM 50
+
+// Campo usado como chave de ordenação.
+#define CRITERIO_NOME       0
+#define CRITERIO_TIPO       1
+#define CRITERIO_PRIORIDADE 2
+#define CRITERIO_TIPO_PRIORIDADE 3 // tipo e, dentro do tipo, prioridade (só nos índices)
+#define NUM_CRITERIOS       4
+
+// Algoritmos do menu de ordenação.
+#define ALGORITMO_INTROSORT 1 // quicksort com heapsort de reserva, O(n log n) no pior caso
+#define ALGORITMO_MERGESORT 2 // estável, O(n log n), usa um vetor auxiliar
+#define ALGORITMO_COUNTING  3 // estável, O(n + k), só para prioridade; ordena índices
+#define ALGORITMO_ORIGINAL  4 // Bubble/Insertion/Selection Sort, O(n^2)
+#define ALGORITMO_PERMUTACAO 5 // estável, ordena índices e move cada componente uma vez no fim
+
+// Abaixo deste tamanho as faixas são terminadas com Insertion Sort.
+#define LIMITE_INSERCAO 16
+
+// Abaixo deste tamanho não vale a pena dividir o trabalho entre threads.
+#define MINIMO_POR_THREAD 4096
+
+// Benchmark das ordenações e buscas (--bench-algoritmos).
+#define DIST_ALEATORIA     0
+#define DIST_ORDENADA      1 // já na ordem do critério
+#define DIST_INVERTIDA     2 // na ordem contrária à do critério
+#define DIST_REPETIDOS     3 // só 16 nomes distintos
+#define NUM_DISTRIBUICOES  4
+#define AQUECIMENTO        2     // execuções descartadas antes de medir
+#define LIMITE_QUADRATICO  5000  // acima disso os algoritmos O(n^2) ficam de fora
+#define CONSULTAS_BUSCA    200   // buscas por medição: metade acha, metade não
+#define FORMATO_CSV        0
+#define FORMATO_JSON       1
+
+// Snapshot binário do inventário (opções 16 e 17, --carregar).
+#define SNAPSHOT_ASSINATURA "FFSNAP\0"
+#define SNAPSHOT_VERSAO     1
+#define ALINHAMENTO_SECAO   64 // cada seção começa num múltiplo disto
+#define NUM_SECOES_SNAPSHOT (NUM_CRITERIOS + 7)
+
+// Tipos distintos que as colunas distinguem; os demais dividem o id TIPO_OUTROS.
+#define MAX_TIPOS   255
+#define TIPO_OUTROS 255
+
+// --- 1. Criação de Structs ---
+
+/**
+ * @struct Componente
+ * @brief Estrutura para armazenar os dados de um componente da torre.
+ * Contém nome, tipo e um nível de prioridade para a montagem.
+ */
+typedef struct {
+    char nome[30];
+    char tipo[20];
+    int prioridade;
+} Componente;
+
+/**
+ * @struct BaldePrioridade
+ * @brief Componentes de uma mesma prioridade esperando montagem, em ordem de
+ * chegada. Guarda só a posição de cada um no inventário, que nunca é reordenado.
+ */
+typedef struct {
+    int *posicoes;
+    int inicio;     // próximo a sair
+    int fim;        // próxima posição livre
+    int capacidade;
+} BaldePrioridade;
+
+/**
+ * @struct FilaMontagem
+ * @brief Fila de prioridade da montagem: um balde por prioridade. Entrar é O(1)
+ * e sair também (no máximo FAIXA_PRIORIDADE baldes são olhados), e componentes
+ * de mesma prioridade saem na ordem em que foram cadastrados.
+ */
+typedef struct {
+    BaldePrioridade baldes[FAIXA_PRIORIDADE];
+    int maior;      // balde mais alto que pode ter componentes (-1 = fila vazia)
+    int quantidade;
+} FilaMontagem;
+
+/**
+ * @struct ColunasInventario
+ * @brief Os mesmos componentes guardados em colunas: prioridade e tipo ocupam um
+ * byte cada, e os nomes ficam um após o outro num único bloco. Uma varredura por
+ * prioridade e tipo lê 2 bytes por componente em vez do registro inteiro.
+ */
+typedef struct {
+    uint8_t *prioridades;
+    uint8_t *tipos;             // id do tipo: posição em nomesTipos, ou TIPO_OUTROS
+    uint32_t *inicioNome;       // onde o nome começa em 'nomes'
+    char *nomes;                // nomes terminados em '\0'
+    size_t tamanhoNomes;
+    size_t capacidadeNomes;
+    char nomesTipos[MAX_TIPOS][20];
+    int numTipos;
+} ColunasInventario;
+
+/**
+ * @struct ArquivoMapeado
+ * @brief Conteúdo de um arquivo inteiro na memória: mapeado com mmap (cópia
+ * privada: o que for alterado não volta ao arquivo) onde existe, lido com
+ * fread no Windows.
+ */
+typedef struct {
+    char *dados;
+    size_t tamanho;
+    int mapeado;
+} ArquivoMapeado;
+
+/**
+ * @struct Inventario
+ * @brief Vetor de componentes que cresce conforme os cadastros, com a contagem
+ * por prioridade (usada pelo Counting Sort) e a fila de montagem sempre em dia.
+ *
+ * O vetor fica na ordem de cadastro. As ordenações ficam nos índices: ordem[c]
+ * tem as posições dos componentes ordenadas pelo critério c (empates na ordem
+ * de cadastro) e é mantido a cada cadastro, assim listar por qualquer chave é
+ * só percorrer o índice e a busca binária por nome está sempre disponível.
+ * A tabela de nomes é um hash aberto (sondagem linear) com a primeira posição
+ * de cada nome distinto, para achar um nome exato em O(1) mesmo com muitos
+ * nomes repetidos.
+ *
+ * Depois de carregarSnapshot os vetores apontam direto para o arquivo mapeado;
+ * o primeiro que precisar crescer é copiado para a memória normal (crescerBloco).
+ */
+typedef struct {
+    Componente *itens;
+    int total;
+    int capacidade;
+    int contagemPrioridade[FAIXA_PRIORIDADE];
+    FilaMontagem montagem;
+    int *ordem[NUM_CRITERIOS];  // cada um com 'capacidade' posições
+    int *tabelaNomes;           // primeira posição do nome em itens, ou -1 se o espaço está livre
+    int capacidadeTabela;       // potência de 2, sempre mais que o dobro de total
+    ColunasInventario colunas;  // cópia em colunas, também com 'capacidade' posições
+    ArquivoMapeado snapshot;    // snapshot carregado: os vetores acima podem apontar para dentro dele
+} Inventario;
+
+// Compara dois componentes pela chave do critério: <0, 0 ou >0, como strcmp.
+typedef int (*ComparadorComponente)(const Componente *a, const Componente *b);
+
+/**
+ * @struct Movimentacao
+ * @brief Quanto uma ordenação copiou: elementos (componentes, índices ou pares)
+ * e bytes. Uma troca de componentes são 3 cópias, 168 bytes.
+ */
+typedef struct {
+    long long elementos;
+    long long bytes;
+} Movimentacao;
+
+/**
+ * @struct CabecalhoSnapshot
+ * @brief Início do arquivo de snapshot. Depois dele vêm, cada uma alinhada em
+ * ALINHAMENTO_SECAO, as seções na ordem de secoesSnapshot: o vetor de
+ * componentes, os índices ordenados, a tabela de nomes e as colunas. Como tudo
+ * já está pronto, carregar é só mapear o arquivo e apontar para cada seção.
+ */
+typedef struct {
+    char assinatura[8];
+    uint32_t versao;
+    uint32_t tamanhoComponente; // sizeof(Componente) de quem gravou
+    int64_t total;
+    int64_t capacidadeTabela;
+    int64_t tamanhoNomes;
+    int32_t numTipos;
+    int32_t reservado;
+} CabecalhoSnapshot;
+
+/**
+ * @struct ResultadoBenchmark
+ * @brief Uma linha do relatório do benchmark: tempos de 'repeticoes' execuções
+ * da mesma operação sobre a mesma entrada.
+ */
+typedef struct {
+    const char *distribuicao;
+    const char *operacao;       // "ordenar por nome", "buscar por nome", ...
+    const char *algoritmo;
+    int tamanho;
+    int repeticoes;
+    long long medianaNs;
+    long long p95Ns;
+    long long comparacoes;      // de uma execução (todas fazem as mesmas)
+    Movimentacao movimentacao;  // idem
+    long long falhasCache;      // média por execução, ou -1 sem contador de hardware
+} ResultadoBenchmark;
+
+
+// --- Protótipos das Funções ---
+
+void limparBufferEntrada();
+void removerQuebraDeLinha(char *str);
+int inicializarInventario(Inventario *inv);
+void liberarInventario(Inventario *inv);
+int adicionarComponente(Inventario *inv, const Componente *c);
+void cadastrarComponente(Inventario *inv);
+int gerarComponentes(Inventario *inv, int quantidade, unsigned int semente);
+void mostrarComponentes(Tela *tela, const Componente componentes[], const int *ordem, int total);
+int reconstruirIndices(Inventario *inv);
+
+// Arquivos
+static int mapearArquivo(const char *arquivo, ArquivoMapeado *a);
+static void desmapearArquivo(ArquivoMapeado *a);
+int importarCSV(Inventario *inv, const char *arquivo, int *rejeitadas);
+int exportarCSV(const Inventario *inv, const char *arquivo);
+int salvarSnapshot(const Inventario *inv, const char *arquivo);
+int carregarSnapshot(Inventario *inv, const char *arquivo);
+
+// Fila de Montagem
+void inicializarFilaMontagem(FilaMontagem *f);
+void liberarFilaMontagem(FilaMontagem *f);
+int enfileirarMontagem(FilaMontagem *f, int prioridade, int posicao);
+int proximoParaMontagem(FilaMontagem *f, int *posicao);
+
+// Algoritmos de Ordenação
+int compararPorNome(const Componente *a, const Componente *b);
+int compararPorTipo(const Componente *a, const Componente *b);
+int compararPorPrioridade(const Componente *a, const Componente *b);
+int compararPorTipoEPrioridade(const Componente *a, const Componente *b);
+ComparadorComponente comparadorDoCriterio(int criterio);
+void bubbleSortPorNome(Componente componentes[], int total, long long *comparacoes, Movimentacao *movimentacao);
+void insertionSortPorTipo(Componente componentes[], int total, long long *comparacoes, Movimentacao *movimentacao);
+void selectionSortPorPrioridade(Componente componentes[], int total, long long *comparacoes, Movimentacao *movimentacao);
+void introsortComponentes(Componente componentes[], int total, ComparadorComponente comparar, long long *comparacoes, Movimentacao *movimentacao);
+int mergeSortComponentes(Componente componentes[], int total, ComparadorComponente comparar, long long *comparacoes, Movimentacao *movimentacao);
+int mergeSortParalelo(Componente componentes[], int total, ComparadorComponente comparar, int threads, long long *comparacoes, Movimentacao *movimentacao);
+int countingSortIndicesPorPrioridade(const Inventario *inv, int indices[], long long *comparacoes, Movimentacao *movimentacao);
+int ordenarPorPermutacao(Componente componentes[], int total, int criterio, long long *comparacoes, Movimentacao *movimentacao);
+int ordenarComponentes(Componente componentes[], int total, int criterio, int algoritmo, long long *comparacoes, Movimentacao *movimentacao);
+const char *nomeDoAlgoritmo(int criterio, int algoritmo);
+
+// Algoritmos de Busca
+int buscaSequencialPorNome(const Componente componentes[], int total, const char *nomeBuscado, int *comparacoes);
+int buscaBinariaPorNome(const Componente componentes[], const int ordemPorNome[], int total, const char *nomeBuscado, int *comparacoes);
+int buscaSequencialParalela(const Componente componentes[], int total, const char *nomeBuscado, int threads, int *comparacoes);
+int buscaHashPorNome(const Inventario *inv, const char *nomeBuscado, int *comparacoes);
+int buscaPorPrefixo(const Inventario *inv, const char *prefixo, int *primeiro, int *comparacoes);
+
+// Varredura em colunas
+int idDoTipo(const ColunasInventario *col, const char *tipo);
+int filtrarColunas(const ColunasInventario *col, int total, int minima, int tipo, int saida[]);
+int filtrarColunasEscalar(const ColunasInventario *col, int inicio, int total, int minima, int tipo, int saida[]);
+int filtrarPorPrioridadeETipo(const Inventario *inv, int minima, const char *tipo, int saida[]);
+int filtrarComponentes(const Componente componentes[], int total, int minima, const char *tipo, int saida[]);
+void benchmarkColunas(int total);
+
+// Desempenho
+static long long agoraNs();
+int threadsDisponiveis();
+void benchmarkAlgoritmos(const char *tamanhos, int repeticoes, int formato);
+void benchmarkArquivos(int total);
+int limitarThreads(int threads, int total);
+void benchmarkParalelo(int total, int maxThreads);
+
+
+// --- Função Principal ---
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench-colunas") == 0) {
+        benchmarkColunas(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-algoritmos") == 0) {
+        int repeticoes = argc > 3 ? atoi(argv[3]) : 15;
+        int formato = argc > 4 && strcmp(argv[4], "json") == 0 ? FORMATO_JSON : FORMATO_CSV;
+        benchmarkAlgoritmos(argc > 2 ? argv[2] : "1000,10000,100000", repeticoes > 0 ? repeticoes : 1, formato);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-arquivos") == 0) {
+        benchmarkArquivos(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-paralelo") == 0) {
+        int maxThreads = argc > 3 ? atoi(argv[3]) : threadsDisponiveis();
+        benchmarkParalelo(argc > 2 ? atoi(argv[2]) : 2000000, maxThreads > 0 ? maxThreads : 1);
+        return 0;
+    }
+
+    Inventario torre;
+    int opcao;
+    // A listagem e o menu seguinte saem juntos, num único write.
+    Tela tela;
+    telaInicializar(&tela, 1, TELA_FLUXO);
+    if (!inicializarInventario(&torre)) {
+        printf("Erro: memoria insuficiente.\n");
+        return 1;
+    }
+    if (argc > 2 && strcmp(argv[1], "--carregar") == 0) {
+        long long inicio = agoraNs();
+        if (carregarSnapshot(&torre, argv[2])) {
+            printf("%d componentes carregados de %s em %.1f ms.\n", torre.total, argv[2], (agoraNs() - inicio) / 1e6);
+        } else {
+            printf("Erro: %s nao e um snapshot valido.\n", argv[2]);
+        }
+    }
+
+    do {
+        telaEscrever(&tela, "\n--- SISTEMA DE MONTAGEM DA TORRE DE RADIO ---\n"
+                            "1. Cadastrar Componente\n"
+                            "2. Listar Componentes Atuais\n"
+                            "3. Ordenar por Nome\n"
+                            "4. Ordenar por Tipo\n"
+                            "5. Ordenar por Prioridade\n"
+                            "6. Buscar Componente por Nome\n"
+                            "7. Gerar Componentes Aleatorios\n"
+                            "8. Montar Proximo Componente (maior prioridade)\n"
+                            "9. Listar por Indice (sem reordenar)\n"
+                            "10. Buscar por Prefixo do Nome\n"
+                            "11. Filtrar por Prioridade Minima e Tipo\n"
+                            "12. Ordenar em Paralelo (Merge Sort)\n"
+                            "13. Buscar por Nome em Paralelo\n"
+                            "14. Importar Componentes de CSV\n"
+                            "15. Exportar Componentes para CSV\n"
+                            "16. Salvar Snapshot Binario\n"
+                            "17. Carregar Snapshot Binario\n"
+                            "0. Sair\n"
+                            "---------------------------------------------\n"
+                            "Escolha uma opcao: ");
+        telaMostrar(&tela);
+        telaLimpar(&tela);
+        if (scanf("%d", &opcao) != 1) opcao = feof(stdin) ? 0 : -1;
+        limparBufferEntrada();
+
+        // Variáveis para medir desempenho
+        long long inicio, fim; // agoraNs(): relógio monotônico, em nanossegundos
+        double tempo_execucao;
+        long long comparacoes = 0;
+        Movimentacao movimentacao = {0, 0};
+
+        switch (opcao) {
+            case 1:
+                cadastrarComponente(&torre);
+                break;
+
+            case 2:
+                mostrarComponentes(&tela, torre.itens, NULL, torre.total);
+                break;
+
+            case 3:
+            case 4:
+            case 5: {
+                int criterio = opcao == 3 ? CRITERIO_NOME : opcao == 4 ? CRITERIO_TIPO : CRITERIO_PRIORIDADE;
+                const char *nomesCriterio[] = {"NOME", "TIPO", "PRIORIDADE"};
+                int algoritmo;
+                telaEscrever(&tela, "Algoritmo: 1. Introsort  2. Merge Sort (estavel)  3. Counting Sort (so prioridade)  4. %s\n"
+                                    "           5. %s\n"
+                                    "Escolha: ", nomeDoAlgoritmo(criterio, ALGORITMO_ORIGINAL), nomeDoAlgoritmo(criterio, ALGORITMO_PERMUTACAO));
+                telaMostrar(&tela);
+                telaLimpar(&tela);
+                if (scanf("%d", &algoritmo) != 1) algoritmo = 0;
+                limparBufferEntrada();
+                if (algoritmo < ALGORITMO_INTROSORT || algoritmo > ALGORITMO_PERMUTACAO) {
+                    printf("Algoritmo invalido.\n");
+                    break;
+                }
+                if (algoritmo == ALGORITMO_COUNTING && criterio != CRITERIO_PRIORIDADE) {
+                    printf("Counting Sort so ordena por prioridade (chaves de %d a %d).\n", PRIORIDADE_MINIMA, PRIORIDADE_MAXIMA);
+                    break;
+                }
+
+                printf("\nOrdenando por %s com %s...\n", nomesCriterio[criterio], nomeDoAlgoritmo(criterio, algoritmo));
+                if (algoritmo == ALGORITMO_COUNTING) {
+                    // Ordena só os índices; o vetor fica como está.
+                    int *indices = (int*) malloc((size_t) (torre.total ? torre.total : 1) * sizeof(int));
+                    if (indices == NULL) {
+                        printf("Erro: memoria insuficiente para ordenar.\n");
+                        break;
+                    }
+                    inicio = agoraNs();
+                    countingSortIndicesPorPrioridade(&torre, indices, &comparacoes, &movimentacao);
+                    fim = agoraNs();
+                    tempo_execucao = (fim - inicio) / 1e6;
+                    printf("Ordenacao concluida (por indices, vetor original intacto)!\n");
+                    printf("=> Comparacoes realizadas: %lld\n", comparacoes);
+                    printf("=> Movimentacoes: %lld elementos, %lld bytes copiados\n", movimentacao.elementos, movimentacao.bytes);
+                    printf("=> Tempo de execucao: %.4f ms\n", tempo_execucao);
+                    mostrarComponentes(&tela, torre.itens, indices, torre.total);
+                    free(indices);
+                    break;
+                }
+                // Os algoritmos que movem componentes trabalham numa cópia, para o
+                // inventário continuar na ordem de cadastro (e os índices valerem).
+                Componente *copia = (Componente*) malloc((size_t) (torre.total ? torre.total : 1) * sizeof(Componente));
+                if (copia == NULL) {
+                    printf("Erro: memoria insuficiente para ordenar.\n");
+                    break;
+                }
+                memcpy(copia, torre.itens, (size_t) torre.total * sizeof(Componente));
+                inicio = agoraNs();
+                int ok = ordenarComponentes(copia, torre.total, criterio, algoritmo, &comparacoes, &movimentacao);
+                fim = agoraNs();
+                if (!ok) {
+                    printf("Erro: memoria insuficiente para ordenar.\n");
+                    free(copia);
+                    break;
+                }
+                tempo_execucao = (fim - inicio) / 1e6; // em milissegundos
+                printf("Ordenacao concluida!\n");
+                printf("=> Comparacoes realizadas: %lld\n", comparacoes);
+                printf("=> Movimentacoes: %lld elementos, %lld bytes copiados\n", movimentacao.elementos, movimentacao.bytes);
+                printf("=> Tempo de execucao: %.4f ms\n", tempo_execucao);
+                mostrarComponentes(&tela, copia, NULL, torre.total);
+                free(copia);
+                break;
+            }
+
+            case 6: {
+                char nomeBusca[30];
+                int comparacoesBusca = 0;
+                int indice;
+
+                printf("Digite o nome do componente a ser buscado: ");
+                fgets(nomeBusca, sizeof(nomeBusca), stdin);
+                removerQuebraDeLinha(nomeBusca);
+
+                // --- Busca Sequencial ---
+                printf("\n--- Realizando Busca Sequencial ---\n");
+                indice = buscaSequencialPorNome(torre.itens, torre.total, nomeBusca, &comparacoesBusca);
+                if (indice != -1) {
+                    printf("Componente encontrado na posicao %d!\n", indice);
+                } else {
+                    printf("Componente nao encontrado.\n");
+                }
+                printf("=> Comparacoes realizadas: %d\n", comparacoesBusca);
+
+                // --- Busca Binária (pelo índice de nomes, sempre ordenado) ---
+                printf("\n--- Realizando Busca Binaria (indice por nome) ---\n");
+                indice = buscaBinariaPorNome(torre.itens, torre.ordem[CRITERIO_NOME], torre.total, nomeBusca, &comparacoesBusca);
+                if (indice != -1) {
+                    printf("Componente encontrado na posicao %d!\n", indice);
+                } else {
+                    printf("Componente nao encontrado.\n");
+                }
+                printf("=> Comparacoes realizadas: %d\n", comparacoesBusca);
+
+                // --- Busca por Hash ---
+                printf("\n--- Realizando Busca por Hash ---\n");
+                indice = buscaHashPorNome(&torre, nomeBusca, &comparacoesBusca);
+                if (indice != -1) {
+                    printf("Componente encontrado na posicao %d!\n", indice);
+                } else {
+                    printf("Componente nao encontrado.\n");
+                }
+                printf("=> Comparacoes realizadas: %d\n", comparacoesBusca);
+                break;
+            }
+
+            case 7: {
+                int quantidade;
+                printf("Quantos componentes gerar? ");
+                if (scanf("%d", &quantidade) != 1 || quantidade <= 0) quantidade = 0;
+                limparBufferEntrada();
+                if (gerarComponentes(&torre, quantidade, (unsigned int) time(NULL))) {
+                    printf("%d componentes gerados. Total no inventario: %d\n", quantidade, torre.total);
+                } else {
+                    printf("Erro: memoria insuficiente. Total no inventario: %d\n", torre.total);
+                }
+                break;
+            }
+
+            case 8: {
+                int posicao;
+                if (proximoParaMontagem(&torre.montagem, &posicao)) {
+                    const Componente *proximo = &torre.itens[posicao];
+                    printf("\nMontando: %s (%s, prioridade %d)\n", proximo->nome, proximo->tipo, proximo->prioridade);
+                    printf("=> Restam %d componentes na fila de montagem.\n", torre.montagem.quantidade);
+                } else {
+                    printf("\nA fila de montagem esta vazia.\n");
+                }
+                break;
+            }
+
+            case 9: {
+                int criterio;
+                telaEscrever(&tela, "Ordem: 1. Nome  2. Tipo  3. Prioridade  4. Tipo e prioridade\n"
+                                    "Escolha: ");
+                telaMostrar(&tela);
+                telaLimpar(&tela);
+                if (scanf("%d", &criterio) != 1) criterio = 0;
+                limparBufferEntrada();
+                if (criterio < 1 || criterio > NUM_CRITERIOS) {
+                    printf("Ordem invalida.\n");
+                    break;
+                }
+                mostrarComponentes(&tela, torre.itens, torre.ordem[criterio - 1], torre.total);
+                break;
+            }
+
+            case 10: {
+                char prefixo[30];
+                int comparacoesBusca = 0, primeiro = 0;
+                printf("Digite o inicio do nome: ");
+                fgets(prefixo, sizeof(prefixo), stdin);
+                removerQuebraDeLinha(prefixo);
+                int encontrados = buscaPorPrefixo(&torre, prefixo, &primeiro, &comparacoesBusca);
+                printf("\n%d componentes comecam com \"%s\".\n", encontrados, prefixo);
+                printf("=> Comparacoes realizadas: %d\n", comparacoesBusca);
+                if (encontrados > 0) mostrarComponentes(&tela, torre.itens, torre.ordem[CRITERIO_NOME] + primeiro, encontrados);
+                break;
+            }
+
+            case 11: {
+                int minima;
+                char tipo[20];
+                printf("Prioridade minima (%d a %d): ", PRIORIDADE_MINIMA, PRIORIDADE_MAXIMA);
+                if (scanf("%d", &minima) != 1) minima = PRIORIDADE_MINIMA;
+                limparBufferEntrada();
+                printf("Tipo: ");
+                fgets(tipo, sizeof(tipo), stdin);
+                removerQuebraDeLinha(tipo);
+                int *encontrados = (int*) malloc((size_t) (torre.total ? torre.total : 1) * sizeof(int));
+                if (encontrados == NULL) {
+                    printf("Erro: memoria insuficiente para filtrar.\n");
+                    break;
+                }
+
+                // Mesma consulta nos dois formatos, para comparar o tempo.
+                inicio = agoraNs();
+                int n = filtrarComponentes(torre.itens, torre.total, minima, tipo, encontrados);
+                fim = agoraNs();
+                printf("\n--- Varredura no vetor de componentes ---\n");
+                printf("=> %d componentes em %.4f ms\n", n, (fim - inicio) / 1e6);
+
+                inicio = agoraNs();
+                n = filtrarPorPrioridadeETipo(&torre, minima, tipo, encontrados);
+                fim = agoraNs();
+                printf("\n--- Varredura nas colunas ---\n");
+                printf("=> %d componentes em %.4f ms\n", n, (fim - inicio) / 1e6);
+                mostrarComponentes(&tela, torre.itens, encontrados, n);
+                free(encontrados);
+                break;
+            }
+
+            case 12: {
+                int criterio, threads;
+                const char *nomesCriterio[] = {"NOME", "TIPO", "PRIORIDADE"};
+                telaEscrever(&tela, "Ordenar por: 1. Nome  2. Tipo  3. Prioridade\n"
+                                    "Escolha: ");
+                telaMostrar(&tela);
+                telaLimpar(&tela);
+                if (scanf("%d", &criterio) != 1) criterio = 0;
+                limparBufferEntrada();
+                if (criterio < 1 || criterio > 3) {
+                    printf("Criterio invalido.\n");
+                    break;
+                }
+                printf("Threads (0 = %d, todos os nucleos): ", threadsDisponiveis());
+                if (scanf("%d", &threads) != 1 || threads <= 0) threads = threadsDisponiveis();
+                limparBufferEntrada();
+
+                // Como nas opções 3 a 5, ordena uma cópia e o inventário fica como está.
+                Componente *copia = (Componente*) malloc((size_t) (torre.total ? torre.total : 1) * sizeof(Componente));
+                if (copia == NULL) {
+                    printf("Erro: memoria insuficiente para ordenar.\n");
+                    break;
+                }
+                memcpy(copia, torre.itens, (size_t) torre.total * sizeof(Componente));
+                printf("\nOrdenando por %s com Merge Sort paralelo...\n", nomesCriterio[criterio - 1]);
+                inicio = agoraNs();
+                int usadas = mergeSortParalelo(copia, torre.total, comparadorDoCriterio(criterio - 1), threads, &comparacoes, &movimentacao);
+                fim = agoraNs();
+                tempo_execucao = (fim - inicio) / 1e6;
+                if (usadas == 0) {
+                    printf("Erro: memoria insuficiente para ordenar.\n");
+                    free(copia);
+                    break;
+                }
+                printf("Ordenacao concluida!\n");
+                printf("=> Comparacoes realizadas: %lld\n", comparacoes);
+                printf("=> Movimentacoes: %lld elementos, %lld bytes copiados\n", movimentacao.elementos, movimentacao.bytes);
+                printf("=> Tempo de execucao: %.4f ms\n", tempo_execucao);
+                printf("=> Threads: %d\n", usadas);
+                mostrarComponentes(&tela, copia, NULL, torre.total);
+                free(copia);
+                break;
+            }
+
+            case 13: {
+                char nomeBusca[30];
+                int comparacoesBusca = 0, threads;
+                printf("Digite o nome do componente a ser buscado: ");
+                fgets(nomeBusca, sizeof(nomeBusca), stdin);
+                removerQuebraDeLinha(nomeBusca);
+                printf("Threads (0 = %d, todos os nucleos): ", threadsDisponiveis());
+                if (scanf("%d", &threads) != 1 || threads <= 0) threads = threadsDisponiveis();
+                limparBufferEntrada();
+
+                printf("\n--- Realizando Busca Sequencial em Paralelo ---\n");
+                inicio = agoraNs();
+                int indice = buscaSequencialParalela(torre.itens, torre.total, nomeBusca, threads, &comparacoesBusca);
+                fim = agoraNs();
+                tempo_execucao = (fim - inicio) / 1e6;
+                if (indice != -1) {
+                    printf("Componente encontrado na posicao %d!\n", indice);
+                } else {
+                    printf("Componente nao encontrado.\n");
+                }
+                printf("=> Comparacoes realizadas: %d\n", comparacoesBusca);
+                printf("=> Tempo de execucao: %.4f ms\n", tempo_execucao);
+                printf("=> Threads: %d\n", limitarThreads(threads, torre.total));
+                break;
+            }
+
+            case 14:
+            case 15:
+            case 16:
+            case 17: {
+                char arquivo[256];
+                printf("Arquivo: ");
+                if (fgets(arquivo, sizeof(arquivo), stdin) == NULL) break;
+                removerQuebraDeLinha(arquivo);
+                inicio = agoraNs();
+                if (opcao == 14) {
+                    int rejeitadas = 0;
+                    int importados = importarCSV(&torre, arquivo, &rejeitadas);
+                    if (importados < 0) {
+                        printf("Erro: nao foi possivel ler %s.\n", arquivo);
+                        break;
+                    }
+                    printf("%d componentes importados, %d linhas invalidas ignoradas.\n", importados, rejeitadas);
+                } else if (opcao == 15) {
+                    if (!exportarCSV(&torre, arquivo)) {
+                        printf("Erro: nao foi possivel gravar %s.\n", arquivo);
+                        break;
+                    }
+                    printf("%d componentes exportados.\n", torre.total);
+                } else if (opcao == 16) {
+                    if (!salvarSnapshot(&torre, arquivo)) {
+                        printf("Erro: nao foi possivel gravar %s.\n", arquivo);
+                        break;
+                    }
+                    printf("Snapshot com %d componentes salvo.\n", torre.total);
+                } else {
+                    if (!carregarSnapshot(&torre, arquivo)) {
+                        printf("Erro: %s nao e um snapshot valido.\n", arquivo);
+                        break;
+                    }
+                    printf("%d componentes carregados.\n", torre.total);
+                }
+                fim = agoraNs();
+                printf("=> Tempo de execucao: %.4f ms\n", (fim - inicio) / 1e6);
+                break;
+            }
+            
+            case 0:
+                printf("Encerrando sistema de montagem...\n");
+                break;
+
+            default:
+                printf("Opcao invalida. Tente novamente.\n");
+        }
+
+    } while (opcao != 0);
+
+    telaLiberar(&tela);
+    liberarInventario(&torre);
+    return 0;
+}
+
+
+// --- Implementação das Funções Auxiliares ---
+
+/**
+ * @brief Limpa o buffer de entrada do teclado.
+ * Essencial após usar scanf para ler números, antes de ler strings.
+ */
+void limparBufferEntrada() {
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF);
+}
+
+/**
+ * @brief Remove o caractere de quebra de linha ('\n') do final de uma string lida com fgets.
+ */
+void removerQuebraDeLinha(char *str) {
+    str[strcspn(str, "\n")] = 0;
+}
+
+/**
+ * @brief Prepara um inventário vazio com CAPACIDADE_INICIAL posições.
+ * @return 1 se deu certo, 0 se faltou memória.
+ */
+int inicializarInventario(Inventario *inv) {
+    int ok = 1;
+    inv->total = 0;
+    inv->capacidade = CAPACIDADE_INICIAL;
+    memset(&inv->snapshot, 0, sizeof(inv->snapshot));
+    memset(inv->contagemPrioridade, 0, sizeof(inv->contagemPrioridade));
+    inicializarFilaMontagem(&inv->montagem);
+    inv->itens = (Componente*) malloc(inv->capacidade * sizeof(Componente));
+    ok = ok && inv->itens != NULL;
+    for (int k = 0; k < NUM_CRITERIOS; k++) {
+        inv->ordem[k] = (int*) malloc(inv->capacidade * sizeof(int));
+        ok = ok && inv->ordem[k] != NULL;
+    }
+    ColunasInventario *col = &inv->colunas;
+    col->prioridades = (uint8_t*) malloc(inv->capacidade);
+    col->tipos = (uint8_t*) malloc(inv->capacidade);
+    col->inicioNome = (uint32_t*) malloc(inv->capacidade * sizeof(uint32_t));
+    col->capacidadeNomes = (size_t) inv->capacidade * 16;
+    col->nomes = (char*) malloc(col->capacidadeNomes);
+    col->tamanhoNomes = 0;
+    col->numTipos = 0;
+    ok = ok && col->prioridades && col->tipos && col->inicioNome && col->nomes;
+    inv->capacidadeTabela = 2 * CAPACIDADE_INICIAL;
+    inv->tabelaNomes = (int*) malloc(inv->capacidadeTabela * sizeof(int));
+    if (inv->tabelaNomes != NULL) memset(inv->tabelaNomes, 0xff, inv->capacidadeTabela * sizeof(int)); // tudo -1
+    return ok && inv->tabelaNomes != NULL;
+}
+
+// O bloco está dentro do snapshot mapeado (e não veio do malloc)?
+static int blocoDoSnapshot(const Inventario *inv, const void *bloco) {
+    const char *p = (const char*) bloco;
+    return inv->snapshot.dados != NULL && p >= inv->snapshot.dados && p <= inv->snapshot.dados + inv->snapshot.tamanho;
+}
+
+static void liberarBloco(const Inventario *inv, void *bloco) {
+    if (!blocoDoSnapshot(inv, bloco)) free(bloco);
+}
+
+/**
+ * @brief Aumenta um bloco do inventário de 'tamanhoAtual' para 'novoTamanho'
+ * bytes: realloc, ou, se o bloco está no snapshot, um malloc novo com cópia.
+ * @return 1 se deu certo, 0 se faltou memória (o bloco continua como estava).
+ */
+static int crescerBloco(const Inventario *inv, void **bloco, size_t tamanhoAtual, size_t novoTamanho) {
+    void *maior;
+    if (blocoDoSnapshot(inv, *bloco)) {
+        maior = malloc(novoTamanho);
+        if (maior != NULL) memcpy(maior, *bloco, tamanhoAtual);
+    } else {
+        maior = realloc(*bloco, novoTamanho);
+    }
+    if (maior == NULL) return 0;
+    *bloco = maior;
+    return 1;
+}
+
+void liberarInventario(Inventario *inv) {
+    liberarBloco(inv, inv->itens);
+    inv->itens = NULL;
+    inv->total = inv->capacidade = 0;
+    for (int k = 0; k < NUM_CRITERIOS; k++) {
+        liberarBloco(inv, inv->ordem[k]);
+        inv->ordem[k] = NULL;
+    }
+    liberarBloco(inv, inv->tabelaNomes);
+    inv->tabelaNomes = NULL;
+    inv->capacidadeTabela = 0;
+    liberarBloco(inv, inv->colunas.prioridades);
+    liberarBloco(inv, inv->colunas.tipos);
+    liberarBloco(inv, inv->colunas.inicioNome);
+    liberarBloco(inv, inv->colunas.nomes);
+    memset(&inv->colunas, 0, sizeof(inv->colunas));
+    liberarFilaMontagem(&inv->montagem);
+    desmapearArquivo(&inv->snapshot);
+}
+
+// FNV-1a de 32 bits do nome.
+static uint32_t hashNome(const char *nome) {
+    uint32_t h = 2166136261u;
+    for (; *nome; nome++) h = (h ^ (unsigned char) *nome) * 16777619u;
+    return h;
+}
+
+// Põe a posição na tabela, a não ser que o nome já esteja lá: as cópias de um
+// nome não entram, senão formariam um bloco que toda sondagem teria de percorrer.
+static void inserirNaTabelaNomes(Inventario *inv, int posicao) {
+    const char *nome = inv->itens[posicao].nome;
+    uint32_t mascara = (uint32_t) inv->capacidadeTabela - 1;
+    uint32_t i = hashNome(nome) & mascara;
+    for (; inv->tabelaNomes[i] != -1; i = (i + 1) & mascara) {
+        if (strcmp(inv->itens[inv->tabelaNomes[i]].nome, nome) == 0) return;
+    }
+    inv->tabelaNomes[i] = posicao;
+}
+
+/**
+ * @brief Troca a tabela de nomes por uma com 'nova' posições e reinsere tudo.
+ * @return 1 se deu certo, 0 se faltou memória (a tabela antiga continua valendo).
+ */
+static int redimensionarTabelaNomes(Inventario *inv, int nova) {
+    int *tabela = (int*) malloc((size_t) nova * sizeof(int));
+    if (tabela == NULL) return 0;
+    memset(tabela, 0xff, (size_t) nova * sizeof(int));
+    liberarBloco(inv, inv->tabelaNomes);
+    inv->tabelaNomes = tabela;
+    inv->capacidadeTabela = nova;
+    // Em ordem de cadastro, para cada nome continuar com a sua primeira posição.
+    for (int i = 0; i < inv->total; i++) inserirNaTabelaNomes(inv, i);
+    return 1;
+}
+
+/**
+ * @brief Põe a posição do componente no índice do critério, depois dos iguais
+ * (busca binária pelo ponto de inserção e um memmove das posições seguintes).
+ * O índice deve conter as posições de 0 a posicao - 1.
+ */
+static void inserirNaOrdem(Inventario *inv, int criterio, int posicao) {
+    ComparadorComponente comparar = comparadorDoCriterio(criterio);
+    int *ordem = inv->ordem[criterio];
+    const Componente *novo = &inv->itens[posicao];
+    int esquerda = 0, direita = posicao; // primeiro elemento maior que o novo
+    while (esquerda < direita) {
+        int meio = esquerda + (direita - esquerda) / 2;
+        if (comparar(novo, &inv->itens[ordem[meio]]) < 0) direita = meio;
+        else esquerda = meio + 1;
+    }
+    memmove(ordem + esquerda + 1, ordem + esquerda, (size_t) (posicao - esquerda) * sizeof(int));
+    ordem[esquerda] = posicao;
+}
+
+// Leva uma coluna de 'capacidade' para 'nova' posições de 'tamanho' bytes; 0 se faltou memória.
+static int crescerColuna(const Inventario *inv, void **coluna, int nova, size_t tamanho) {
+    return crescerBloco(inv, coluna, (size_t) inv->capacidade * tamanho, (size_t) nova * tamanho);
+}
+
+/**
+ * @brief Id do tipo nas colunas, internando-o se for novo. Passados MAX_TIPOS
+ * tipos distintos, os seguintes ficam todos com TIPO_OUTROS.
+ */
+static int internarTipo(ColunasInventario *col, const char *tipo) {
+    int id = idDoTipo(col, tipo);
+    if (id >= 0) return id;
+    if (col->numTipos == MAX_TIPOS) return TIPO_OUTROS;
+    snprintf(col->nomesTipos[col->numTipos], sizeof(col->nomesTipos[0]), "%s", tipo);
+    return col->numTipos++;
+}
+
+/**
+ * @brief Copia o componente para a posição 'posicao' das colunas, que já têm espaço.
+ * @return 1 se deu certo, 0 se faltou memória para o nome.
+ */
+static int guardarNasColunas(Inventario *inv, int posicao, const Componente *c) {
+    ColunasInventario *col = &inv->colunas;
+    size_t tamanho = strlen(c->nome) + 1;
+    if (col->tamanhoNomes + tamanho > col->capacidadeNomes) {
+        size_t nova = (col->capacidadeNomes + tamanho) * 2;
+        if (!crescerBloco(inv, (void**) &col->nomes, col->tamanhoNomes, nova)) return 0;
+        col->capacidadeNomes = nova;
+    }
+    memcpy(col->nomes + col->tamanhoNomes, c->nome, tamanho);
+    col->inicioNome[posicao] = (uint32_t) col->tamanhoNomes;
+    col->tamanhoNomes += tamanho;
+    col->prioridades[posicao] = (uint8_t) c->prioridade;
+    col->tipos[posicao] = (uint8_t) internarTipo(col, c->tipo);
+    return 1;
+}
+
+/**
+ * @brief Guarda o componente no fim do vetor, nas colunas, na tabela de nomes,
+ * na contagem e na fila de montagem, crescendo o que for preciso. Os índices
+ * ordenados ficam por conta de quem chama.
+ * @return 1 se deu certo, 0 se faltou memória (o inventário continua válido).
+ */
+static int guardarComponente(Inventario *inv, const Componente *c) {
+    if (inv->total == inv->capacidade) {
+        int nova = inv->capacidade ? inv->capacidade * 2 : CAPACIDADE_INICIAL;
+        if (!crescerColuna(inv, (void**) &inv->itens, nova, sizeof(Componente))) return 0;
+        for (int k = 0; k < NUM_CRITERIOS; k++) {
+            if (!crescerColuna(inv, (void**) &inv->ordem[k], nova, sizeof(int))) return 0;
+        }
+        if (!crescerColuna(inv, (void**) &inv->colunas.prioridades, nova, 1) ||
+            !crescerColuna(inv, (void**) &inv->colunas.tipos, nova, 1) ||
+            !crescerColuna(inv, (void**) &inv->colunas.inicioNome, nova, sizeof(uint32_t))) return 0;
+        inv->capacidade = nova;
+    }
+    if (2 * (inv->total + 1) > inv->capacidadeTabela && !redimensionarTabelaNomes(inv, inv->capacidadeTabela * 2)) return 0;
+    if (!guardarNasColunas(inv, inv->total, c)) return 0;
+    if (!enfileirarMontagem(&inv->montagem, c->prioridade, inv->total)) return 0;
+    inv->itens[inv->total] = *c;
+    inserirNaTabelaNomes(inv, inv->total);
+    inv->total++;
+    inv->contagemPrioridade[c->prioridade - PRIORIDADE_MINIMA]++;
+    return 1;
+}
+
+/**
+ * @brief Acrescenta um componente ao fim do inventário, dobrando a capacidade se
+ * preciso, coloca-o na fila de montagem e atualiza todos os índices.
+ * @return 1 se deu certo, 0 se faltou memória (o inventário continua válido).
+ */
+int adicionarComponente(Inventario *inv, const Componente *c) {
+    if (!guardarComponente(inv, c)) return 0;
+    for (int k = 0; k < NUM_CRITERIOS; k++) inserirNaOrdem(inv, k, inv->total - 1);
+    return 1;
+}
+
+// Soma 'n' cópias de elementos de 'tamanho' bytes à movimentação.
+static inline void contarMovimentos(Movimentacao *movimentacao, long long n, size_t tamanho) {
+    movimentacao->elementos += n;
+    movimentacao->bytes += n * (long long) tamanho;
+}
+
+static inline void zerarMovimentacao(Movimentacao *movimentacao) {
+    movimentacao->elementos = movimentacao->bytes = 0;
+}
+
+/**
+ * @brief Merge Sort estável de chaves pequenas em [inicio, fim): posições de
+ * componentes ou pares (chave, posição). 'menor(a, b)' diz se a chave a vem
+ * antes da b. Mesmo esquema de mergeSortFaixa, mas move só as chaves.
+ */
+template <typename Chave, typename Menor>
+static void mergeSortChavesFaixa(Chave v[], Chave auxiliar[], int inicio, int fim, Menor menor, long long *comparacoes, Movimentacao *movimentacao) {
+    // Contadores locais: somados uma vez no fim, fora dos laços.
+    long long feitas = 0, movidos = 0;
+    if (fim - inicio <= LIMITE_INSERCAO) {
+        for (int i = inicio + 1; i < fim; i++) {
+            Chave chave = v[i];
+            int j = i - 1;
+            while (j >= inicio) {
+                feitas++;
+                if (!menor(chave, v[j])) break;
+                v[j + 1] = v[j];
+                j--;
+            }
+            v[j + 1] = chave;
+            movidos += i - j + 1; // a chave sai, i - 1 - j deslocadas, a chave volta
+        }
+        *comparacoes += feitas;
+        contarMovimentos(movimentacao, movidos, sizeof(Chave));
+        return;
+    }
+    int meio = inicio + (fim - inicio) / 2;
+    mergeSortChavesFaixa(v, auxiliar, inicio, meio, menor, comparacoes, movimentacao);
+    mergeSortChavesFaixa(v, auxiliar, meio, fim, menor, comparacoes, movimentacao);
+    (*comparacoes)++;
+    if (!menor(v[meio], v[meio - 1])) return; // já em ordem
+    memcpy(auxiliar + inicio, v + inicio, (size_t) (fim - inicio) * sizeof(Chave));
+    int i = inicio, j = meio, k = inicio;
+    while (i < meio && j < fim) {
+        feitas++;
+        if (menor(auxiliar[j], auxiliar[i])) v[k++] = auxiliar[j++];
+        else v[k++] = auxiliar[i++];
+    }
+    while (i < meio) v[k++] = auxiliar[i++];
+    while (j < fim) v[k++] = auxiliar[j++];
+    *comparacoes += feitas;
+    contarMovimentos(movimentacao, 2LL * (fim - inicio), sizeof(Chave));
+}
+
+/**
+ * @brief Merge Sort estável de posições, comparando os componentes que elas indicam.
+ */
+static void mergeSortIndicesFaixa(const Componente v[], int ordem[], int auxiliar[], int inicio, int fim, ComparadorComponente comparar,
+                                  long long *comparacoes, Movimentacao *movimentacao) {
+    mergeSortChavesFaixa(ordem, auxiliar, inicio, fim, [v, comparar](int a, int b) { return comparar(&v[a], &v[b]) < 0; },
+                         comparacoes, movimentacao);
+}
+
+int reconstruirIndices(Inventario *inv) {
+    long long comparacoes = 0;
+    Movimentacao movimentacao = {0, 0};
+    int n = inv->total;
+    int *auxiliar = (int*) malloc((size_t) (n ? n : 1) * sizeof(int));
+    if (auxiliar == NULL) return 0;
+    countingSortIndicesPorPrioridade(inv, inv->ordem[CRITERIO_PRIORIDADE], &comparacoes, &movimentacao);
+    for (int i = 0; i < n; i++) inv->ordem[CRITERIO_NOME][i] = inv->ordem[CRITERIO_TIPO][i] = i;
+    mergeSortIndicesFaixa(inv->itens, inv->ordem[CRITERIO_NOME], auxiliar, 0, n, compararPorNome, &comparacoes, &movimentacao);
+    mergeSortIndicesFaixa(inv->itens, inv->ordem[CRITERIO_TIPO], auxiliar, 0, n, compararPorTipo, &comparacoes, &movimentacao);
+    // Ordenar por tipo, de forma estável, o que já está por prioridade dá tipo+prioridade.
+    memcpy(inv->ordem[CRITERIO_TIPO_PRIORIDADE], inv->ordem[CRITERIO_PRIORIDADE], (size_t) n * sizeof(int));
+    mergeSortIndicesFaixa(inv->itens, inv->ordem[CRITERIO_TIPO_PRIORIDADE], auxiliar, 0, n, compararPorTipo, &comparacoes, &movimentacao);
+    free(auxiliar);
+    return 1;
+}
+
+/**
+ * @brief Cadastra um novo componente no inventário.
+ */
+void cadastrarComponente(Inventario *inv) {
+    Componente novo;
+    printf("\n--- Cadastro de Novo Componente ---\n");
+    printf("Nome: ");
+    fgets(novo.nome, sizeof(novo.nome), stdin);
+    removerQuebraDeLinha(novo.nome);
+
+    printf("Tipo (controle, suporte, propulsao): ");
+    fgets(novo.tipo, sizeof(novo.tipo), stdin);
+    removerQuebraDeLinha(novo.tipo);
+    // No CSV o tipo é o penúltimo campo; com uma vírgula ele voltaria partido.
+    while (strchr(novo.tipo, ',') != NULL) {
+        printf("O tipo nao pode ter virgula. Digite outro tipo: ");
+        if (fgets(novo.tipo, sizeof(novo.tipo), stdin) == NULL) return;
+        removerQuebraDeLinha(novo.tipo);
+    }
+
+    printf("Prioridade (%d a %d): ", PRIORIDADE_MINIMA, PRIORIDADE_MAXIMA);
+    while (scanf("%d", &novo.prioridade) != 1 || novo.prioridade < PRIORIDADE_MINIMA || novo.prioridade > PRIORIDADE_MAXIMA) {
+        if (feof(stdin)) return;
+        limparBufferEntrada();
+        printf("Prioridade invalida. Digite um valor de %d a %d: ", PRIORIDADE_MINIMA, PRIORIDADE_MAXIMA);
+    }
+    limparBufferEntrada();
+
+    if (!adicionarComponente(inv, &novo)) {
+        printf("Nao ha mais espaco para novos componentes!\n");
+        return;
+    }
+    printf("Componente cadastrado com sucesso!\n");
+}
+
+/**
+ * @brief Sorteia um componente: nome "Comp-NNNNNNNN" entre 'nomesDistintos'
+ * possíveis, tipo e prioridade uniformes.
+ */
+static void sortearComponente(uint64_t *estado, unsigned int nomesDistintos, Componente *c) {
+    static const char *tipos[] = {"controle", "suporte", "propulsao"};
+    // splitmix64: barato e com bits bem misturados
+    uint64_t z = (*estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    snprintf(c->nome, sizeof(c->nome), "Comp-%08u", (unsigned int) (z % nomesDistintos));
+    strcpy(c->tipo, tipos[(z >> 32) % 3]);
+    c->prioridade = PRIORIDADE_MINIMA + (int) ((z >> 40) % FAIXA_PRIORIDADE);
+}
+
+/**
+ * @brief Acrescenta 'quantidade' componentes com nome, tipo e prioridade sorteados,
+ * para testar as ordenações e buscas com inventários grandes. Os índices
+ * ordenados são refeitos uma vez no final, em vez de a cada componente.
+ * @return 1 se deu certo, 0 se faltou memória no meio do caminho.
+ */
+int gerarComponentes(Inventario *inv, int quantidade, unsigned int semente) {
+    uint64_t estado = semente;
+    for (int i = 0; i < quantidade; i++) {
+        Componente c;
+        sortearComponente(&estado, 100000000u, &c);
+        if (!guardarComponente(inv, &c)) {
+            reconstruirIndices(inv);
+            return 0;
+        }
+    }
+    return reconstruirIndices(inv);
+}
+
+/**
+ * @brief Exibe todos os componentes cadastrados de forma formatada.
+ * O texto é acrescentado ao quadro da tela, que sai inteiro no próximo telaMostrar.
+ * @param ordem Índices na ordem de exibição, ou NULL para a ordem do vetor.
+ */
+void mostrarComponentes(Tela *tela, const Componente componentes[], const int *ordem, int total) {
+    if (total == 0) {
+        telaEscrever(tela, "\nNenhum componente cadastrado ainda.\n");
+        return;
+    }
+    telaEscrever(tela, "\n------------------- LISTA DE COMPONENTES -------------------\n");
+    telaEscrever(tela, "%-20s | %-15s | %s\n", "NOME", "TIPO", "PRIORIDADE");
+    telaEscrever(tela, "----------------------------------------------------------\n");
+    int mostrados = total < LIMITE_LISTAGEM ? total : LIMITE_LISTAGEM;
+    for (int i = 0; i < mostrados; i++) {
+        const Componente *c = &componentes[ordem ? ordem[i] : i];
+        telaEscrever(tela, "%-20s | %-15s | %d\n", c->nome, c->tipo, c->prioridade);
+    }
+    if (mostrados < total) telaEscrever(tela, "... e mais %d componentes\n", total - mostrados);
+    telaEscrever(tela, "----------------------------------------------------------\n");
+}
+
+
+// --- Implementação da Fila de Montagem ---
+
+void inicializarFilaMontagem(FilaMontagem *f) {
+    memset(f, 0, sizeof(*f));
+    f->maior = -1;
+}
+
+void liberarFilaMontagem(FilaMontagem *f) {
+    for (int p = 0; p < FAIXA_PRIORIDADE; p++) free(f->baldes[p].posicoes);
+    inicializarFilaMontagem(f);
+}
+
+/**
+ * @brief Põe a posição do componente no fim do balde da sua prioridade.
+ * Quando o balde enche, primeiro reaproveita o espaço dos que já saíram; só
+ * depois dobra a capacidade.
+ * @return 1 se deu certo, 0 se faltou memória.
+ */
+int enfileirarMontagem(FilaMontagem *f, int prioridade, int posicao) {
+    int p = prioridade - PRIORIDADE_MINIMA;
+    BaldePrioridade *b = &f->baldes[p];
+    if (b->fim == b->capacidade) {
+        if (b->inicio > b->capacidade / 2) {
+            memmove(b->posicoes, b->posicoes + b->inicio, (size_t) (b->fim - b->inicio) * sizeof(int));
+            b->fim -= b->inicio;
+            b->inicio = 0;
+        } else {
+            int nova = b->capacidade ? b->capacidade * 2 : CAPACIDADE_INICIAL;
+            int *posicoes = (int*) realloc(b->posicoes, (size_t) nova * sizeof(int));
+            if (posicoes == NULL) return 0;
+            b->posicoes = posicoes;
+            b->capacidade = nova;
+        }
+    }
+    b->posicoes[b->fim++] = posicao;
+    if (p > f->maior) f->maior = p;
+    f->quantidade++;
+    return 1;
+}
+
+/**
+ * @brief Retira o componente de maior prioridade (o mais antigo, em caso de empate).
+ * @param posicao Recebe a posição dele no inventário.
+ * @return 1 se havia algum, 0 se a fila estava vazia.
+ */
+int proximoParaMontagem(FilaMontagem *f, int *posicao) {
+    while (f->maior >= 0 && f->baldes[f->maior].inicio == f->baldes[f->maior].fim) f->maior--;
+    if (f->maior < 0) return 0;
+    BaldePrioridade *b = &f->baldes[f->maior];
+    *posicao = b->posicoes[b->inicio++];
+    if (b->inicio == b->fim) b->inicio = b->fim = 0; // balde vazio: recomeça do início
+    f->quantidade--;
+    return 1;
+}
+
+// --- Implementação dos Algoritmos de Ordenação ---
+
+int compararPorNome(const Componente *a, const Componente *b) {
+    return strcmp(a->nome, b->nome);
+}
+
+int compararPorTipo(const Componente *a, const Componente *b) {
+    return strcmp(a->tipo, b->tipo);
+}
+
+int compararPorPrioridade(const Componente *a, const Componente *b) {
+    return (a->prioridade > b->prioridade) - (a->prioridade < b->prioridade);
+}
+
+int compararPorTipoEPrioridade(const Componente *a, const Componente *b) {
+    int res = strcmp(a->tipo, b->tipo);
+    return res != 0 ? res : a->prioridade - b->prioridade;
+}
+
+ComparadorComponente comparadorDoCriterio(int criterio) {
+    static const ComparadorComponente comparadores[NUM_CRITERIOS] = {
+        compararPorNome, compararPorTipo, compararPorPrioridade, compararPorTipoEPrioridade
+    };
+    return comparadores[criterio];
+}
+
+/**
+ * @brief Ordena os componentes por NOME usando o algoritmo Bubble Sort.
+ */
+void bubbleSortPorNome(Componente componentes[], int total, long long *comparacoes, Movimentacao *movimentacao) {
+    *comparacoes = 0;
+    zerarMovimentacao(movimentacao);
+    long long trocas = 0;
+    for (int i = 0; i < total - 1; i++) {
+        for (int j = 0; j < total - i - 1; j++) {
+            (*comparacoes)++;
+            if (strcmp(componentes[j].nome, componentes[j + 1].nome) > 0) {
+                Componente temp = componentes[j];
+                componentes[j] = componentes[j + 1];
+                componentes[j + 1] = temp;
+                trocas++;
+            }
+        }
+    }
+    contarMovimentos(movimentacao, 3 * trocas, sizeof(Componente));
+}
+
+/**
+ * @brief Ordena os componentes por TIPO usando o algoritmo Insertion Sort.
+ */
+void insertionSortPorTipo(Componente componentes[], int total, long long *comparacoes, Movimentacao *movimentacao) {
+    *comparacoes = 0;
+    zerarMovimentacao(movimentacao);
+    long long movidos = 0;
+    for (int i = 1; i < total; i++) {
+        Componente chave = componentes[i];
+        int j = i - 1;
+        while (j >= 0) {
+            (*comparacoes)++;
+            if (strcmp(chave.tipo, componentes[j].tipo) < 0) {
+                componentes[j + 1] = componentes[j];
+                j--;
+            } else {
+                break;
+            }
+        }
+        componentes[j + 1] = chave;
+        movidos += i - j + 1; // a chave sai, i - 1 - j deslocados, a chave volta
+    }
+    contarMovimentos(movimentacao, movidos, sizeof(Componente));
+}
+
+/**
+ * @brief Ordena os componentes por PRIORIDADE usando o algoritmo Selection Sort.
+ */
+void selectionSortPorPrioridade(Componente componentes[], int total, long long *comparacoes, Movimentacao *movimentacao) {
+    *comparacoes = 0;
+    zerarMovimentacao(movimentacao);
+    for (int i = 0; i < total - 1; i++) {
+        int indice_menor = i;
+        for (int j = i + 1; j < total; j++) {
+            (*comparacoes)++;
+            if (componentes[j].prioridade < componentes[indice_menor].prioridade) {
+                indice_menor = j;
+            }
+        }
+        if (indice_menor != i) {
+            Componente temp = componentes[i];
+            componentes[i] = componentes[indice_menor];
+            componentes[indice_menor] = temp;
+            contarMovimentos(movimentacao, 3, sizeof(Componente));
+        }
+    }
+}
+
+/**
+ * @brief Insertion Sort na faixa [inicio, fim). Estável; usado nas faixas pequenas
+ * do Introsort e do Merge Sort.
+ */
+static void insertionSortFaixa(Componente componentes[], int inicio, int fim, ComparadorComponente comparar, long long *comparacoes,
+                               Movimentacao *movimentacao) {
+    long long movidos = 0;
+    for (int i = inicio + 1; i < fim; i++) {
+        Componente chave = componentes[i];
+        int j = i - 1;
+        while (j >= inicio) {
+            (*comparacoes)++;
+            if (comparar(&chave, &componentes[j]) < 0) {
+                componentes[j + 1] = componentes[j];
+                j--;
+            } else {
+                break;
+            }
+        }
+        componentes[j + 1] = chave;
+        movidos += i - j + 1;
+    }
+    contarMovimentos(movimentacao, movidos, sizeof(Componente));
+}
+
+static void trocarComponentes(Componente *a, Componente *b, Movimentacao *movimentacao) {
+    Componente temp = *a;
+    *a = *b;
+    *b = temp;
+    contarMovimentos(movimentacao, 3, sizeof(Componente));
+}
+
+/**
+ * @brief Desce o elemento 'raiz' no heap de máximo v[0..n).
+ */
+static void peneirar(Componente v[], int raiz, int n, ComparadorComponente comparar, long long *comparacoes, Movimentacao *movimentacao) {
+    for (;;) {
+        int maior = raiz, filho = 2 * raiz + 1;
+        if (filho < n) {
+            (*comparacoes)++;
+            if (comparar(&v[filho], &v[maior]) > 0) maior = filho;
+        }
+        if (filho + 1 < n) {
+            (*comparacoes)++;
+            if (comparar(&v[filho + 1], &v[maior]) > 0) maior = filho + 1;
+        }
+        if (maior == raiz) return;
+        trocarComponentes(&v[raiz], &v[maior], movimentacao);
+        raiz = maior;
+    }
+}
+
+/**
+ * @brief Heapsort de v[0..n): reserva do Introsort quando a recursão fica funda demais.
+ */
+static void heapSortFaixa(Componente v[], int n, ComparadorComponente comparar, long long *comparacoes, Movimentacao *movimentacao) {
+    for (int i = n / 2 - 1; i >= 0; i--) peneirar(v, i, n, comparar, comparacoes, movimentacao);
+    for (int fim = n - 1; fim > 0; fim--) {
+        trocarComponentes(&v[0], &v[fim], movimentacao);
+        peneirar(v, 0, fim, comparar, comparacoes, movimentacao);
+    }
+}
+
+/**
+ * @brief Quicksort com mediana de três na faixa [inicio, fim). Passado o limite de
+ * profundidade troca para Heapsort, e faixas pequenas ficam para o Insertion Sort.
+ * Recursão só na metade menor, para a pilha ficar em O(log n).
+ */
+static void introsortFaixa(Componente v[], int inicio, int fim, int profundidade, ComparadorComponente comparar, long long *comparacoes,
+                           Movimentacao *movimentacao) {
+    while (fim - inicio > LIMITE_INSERCAO) {
+        if (profundidade-- == 0) {
+            heapSortFaixa(v + inicio, fim - inicio, comparar, comparacoes, movimentacao);
+            return;
+        }
+        // Mediana de três: ordena primeiro, meio e último; o pivô fica no meio.
+        int meio = inicio + (fim - inicio - 1) / 2;
+        (*comparacoes) += 3;
+        if (comparar(&v[meio], &v[inicio]) < 0) trocarComponentes(&v[meio], &v[inicio], movimentacao);
+        if (comparar(&v[fim - 1], &v[meio]) < 0) trocarComponentes(&v[fim - 1], &v[meio], movimentacao);
+        if (comparar(&v[meio], &v[inicio]) < 0) trocarComponentes(&v[meio], &v[inicio], movimentacao);
+        Componente pivo = v[meio];
+        contarMovimentos(movimentacao, 1, sizeof(Componente));
+
+        // Partição de Hoare: ao final, [inicio, j] <= pivô <= [j + 1, fim).
+        int i = inicio - 1, j = fim;
+        for (;;) {
+            do { i++; (*comparacoes)++; } while (comparar(&v[i], &pivo) < 0);
+            do { j--; (*comparacoes)++; } while (comparar(&pivo, &v[j]) < 0);
+            if (i >= j) break;
+            trocarComponentes(&v[i], &v[j], movimentacao);
+        }
+        if (j + 1 - inicio < fim - (j + 1)) {
+            introsortFaixa(v, inicio, j + 1, profundidade, comparar, comparacoes, movimentacao);
+            inicio = j + 1;
+        } else {
+            introsortFaixa(v, j + 1, fim, profundidade, comparar, comparacoes, movimentacao);
+            fim = j + 1;
+        }
+    }
+    insertionSortFaixa(v, inicio, fim, comparar, comparacoes, movimentacao);
+}
+
+/**
+ * @brief Ordena com Introsort: O(n log n) no pior caso, sem memória extra. Não é estável.
+ */
+void introsortComponentes(Componente componentes[], int total, ComparadorComponente comparar, long long *comparacoes, Movimentacao *movimentacao) {
+    *comparacoes = 0;
+    zerarMovimentacao(movimentacao);
+    int profundidade = 0;
+    for (int n = total; n > 1; n >>= 1) profundidade += 2; // 2 * log2(n)
+    introsortFaixa(componentes, 0, total, profundidade, comparar, comparacoes, movimentacao);
+}
+
+/**
+ * @brief Intercala a[0..na) e b[0..nb), já ordenados, em saida[0..na + nb).
+ */
+static void intercalar(const Componente a[], int na, const Componente b[], int nb, Componente saida[], ComparadorComponente comparar, long long *comparacoes,
+                       Movimentacao *movimentacao) {
+    int i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        (*comparacoes)++;
+        // '<=' mantém à frente o elemento da esquerda em caso de empate: estável.
+        if (comparar(&a[i], &b[j]) <= 0) saida[k++] = a[i++];
+        else saida[k++] = b[j++];
+    }
+    memcpy(saida + k, a + i, (size_t) (na - i) * sizeof(Componente));
+    memcpy(saida + k + (na - i), b + j, (size_t) (nb - j) * sizeof(Componente));
+    contarMovimentos(movimentacao, na + nb, sizeof(Componente));
+}
+
+/**
+ * @brief Ordena [inicio, fim) intercalando as metades em 'auxiliar'. Se a metade
+ * esquerda já termina antes da direita começar, a intercalação é pulada.
+ */
+static void mergeSortFaixa(Componente v[], Componente auxiliar[], int inicio, int fim, ComparadorComponente comparar, long long *comparacoes,
+                           Movimentacao *movimentacao) {
+    if (fim - inicio <= LIMITE_INSERCAO) {
+        insertionSortFaixa(v, inicio, fim, comparar, comparacoes, movimentacao);
+        return;
+    }
+    int meio = inicio + (fim - inicio) / 2;
+    mergeSortFaixa(v, auxiliar, inicio, meio, comparar, comparacoes, movimentacao);
+    mergeSortFaixa(v, auxiliar, meio, fim, comparar, comparacoes, movimentacao);
+    (*comparacoes)++;
+    if (comparar(&v[meio - 1], &v[meio]) <= 0) return;
+
+    intercalar(&v[inicio], meio - inicio, &v[meio], fim - meio, &auxiliar[inicio], comparar, comparacoes, movimentacao);
+    memcpy(&v[inicio], &auxiliar[inicio], (size_t) (fim - inicio) * sizeof(Componente));
+    contarMovimentos(movimentacao, fim - inicio, sizeof(Componente));
+}
+
+/**
+ * @brief Ordena com Merge Sort: estável e O(n log n), com um vetor auxiliar de n posições.
+ * @return 1 se deu certo, 0 se faltou memória (o vetor fica como estava).
+ */
+int mergeSortComponentes(Componente componentes[], int total, ComparadorComponente comparar, long long *comparacoes, Movimentacao *movimentacao) {
+    *comparacoes = 0;
+    zerarMovimentacao(movimentacao);
+    if (total < 2) return 1;
+    Componente *auxiliar = (Componente*) malloc((size_t) total * sizeof(Componente));
+    if (auxiliar == NULL) return 0;
+    mergeSortFaixa(componentes, auxiliar, 0, total, comparar, comparacoes, movimentacao);
+    free(auxiliar);
+    return 1;
+}
+
+/**
+ * @brief Quantos elementos de 'a' estão entre os 'k' primeiros da intercalação
+ * estável de a[0..na) com b[0..nb) (busca binária, sem intercalar nada).
+ */
+static int dividirIntercalacao(const Componente a[], int na, const Componente b[], int nb, int k, ComparadorComponente comparar, long long *comparacoes) {
+    int esquerda = k > nb ? k - nb : 0, direita = k < na ? k : na;
+    while (esquerda < direita) {
+        int i = esquerda + (direita - esquerda) / 2, j = k - i;
+        (*comparacoes)++;
+        // a[i] sai antes de b[j - 1] (empate fica com a): então a[i] está entre os k primeiros.
+        if (comparar(&a[i], &b[j - 1]) <= 0) esquerda = i + 1;
+        else direita = i;
+    }
+    return esquerda;
+}
+
+// Roda tarefa(0), ..., tarefa(n - 1), cada uma numa thread; a 0 fica com quem chamou.
+template <typename Tarefa>
+static void executarEmParalelo(int n, Tarefa tarefa) {
+    std::vector<std::thread> trabalhadores;
+    for (int t = 1; t < n; t++) trabalhadores.emplace_back(tarefa, t);
+    tarefa(0);
+    for (std::thread &trabalhador : trabalhadores) trabalhador.join();
+}
+
+/**
+ * @brief Merge Sort em paralelo, estável como o sequencial. Cada thread ordena
+ * um bloco; depois os blocos vizinhos são intercalados em rodadas, dobrando de
+ * tamanho, alternando entre o vetor e o auxiliar. Em cada rodada as
+ * intercalações são repartidas (por busca binária) para todas as threads
+ * continuarem ocupadas até a última.
+ * @return Quantas threads foram usadas (menos que 'threads' se o vetor for
+ * pequeno), ou 0 se faltou memória (o vetor fica como estava).
+ */
+int mergeSortParalelo(Componente componentes[], int total, ComparadorComponente comparar, int threads, long long *comparacoes,
+                      Movimentacao *movimentacao) {
+    *comparacoes = 0;
+    zerarMovimentacao(movimentacao);
+    threads = limitarThreads(threads, total);
+    Componente *auxiliar = (Componente*) malloc((size_t) (total ? total : 1) * sizeof(Componente));
+    if (auxiliar == NULL) return 0;
+    std::vector<int> limites(threads + 1);
+    for (int b = 0; b <= threads; b++) limites[b] = (int) ((long long) total * b / threads);
+    std::vector<long long> contagem(threads, 0);
+    std::vector<Movimentacao> movidos(threads, Movimentacao{0, 0});
+
+    // Cada tarefa conta em variáveis suas e grava no vetor compartilhado só no
+    // fim: contadores vizinhos no vetor dividiriam a mesma linha de cache.
+    executarEmParalelo(threads, [&](int t) {
+        long long feitas = 0;
+        Movimentacao movidas = {0, 0};
+        mergeSortFaixa(componentes, auxiliar, limites[t], limites[t + 1], comparar, &feitas, &movidas);
+        contagem[t] = feitas;
+        movidos[t] = movidas;
+    });
+
+    Componente *origem = componentes, *destino = auxiliar;
+    for (int passo = 1; passo < threads; passo *= 2) {
+        int pares = 0;
+        for (int b = 0; b + passo < threads; b += 2 * passo) pares++;
+        int partes = threads / pares;
+        executarEmParalelo(pares * partes, [&](int t) {
+            int b = (t / partes) * 2 * passo, parte = t % partes;
+            int inicio = limites[b], meio = limites[b + passo];
+            int fim = limites[b + 2 * passo < threads ? b + 2 * passo : threads];
+            const Componente *a = origem + inicio, *c = origem + meio;
+            int na = meio - inicio, nc = fim - meio;
+            int k0 = (int) ((long long) (na + nc) * parte / partes);
+            int k1 = (int) ((long long) (na + nc) * (parte + 1) / partes);
+            long long feitas = 0;
+            Movimentacao movidas = {0, 0};
+            int i0 = dividirIntercalacao(a, na, c, nc, k0, comparar, &feitas);
+            int i1 = dividirIntercalacao(a, na, c, nc, k1, comparar, &feitas);
+            intercalar(a + i0, i1 - i0, c + (k0 - i0), (k1 - i1) - (k0 - i0), destino + inicio + k0, comparar, &feitas, &movidas);
+            contagem[t] += feitas;
+            movidos[t].elementos += movidas.elementos;
+            movidos[t].bytes += movidas.bytes;
+        });
+        // Um bloco sem par nesta rodada só muda de vetor.
+        int sobra = (threads - 1) / (2 * passo) * 2 * passo;
+        if (sobra + passo >= threads) {
+            memcpy(destino + limites[sobra], origem + limites[sobra], (size_t) (total - limites[sobra]) * sizeof(Componente));
+            contarMovimentos(movimentacao, total - limites[sobra], sizeof(Componente));
+        }
+        Componente *troca = origem;
+        origem = destino;
+        destino = troca;
+    }
+    if (origem != componentes) {
+        memcpy(componentes, origem, (size_t) total * sizeof(Componente));
+        contarMovimentos(movimentacao, total, sizeof(Componente));
+    }
+    free(auxiliar);
+    for (int t = 0; t < threads; t++) {
+        *comparacoes += contagem[t];
+        movimentacao->elementos += movidos[t].elementos;
+        movimentacao->bytes += movidos[t].bytes;
+    }
+    return threads;
+}
+
+/**
+ * @brief Ordena por prioridade com Counting Sort, escrevendo em 'indices' as
+ * posições dos componentes em ordem crescente de prioridade (estável: empates
+ * na ordem do vetor). O inventário já mantém a contagem por prioridade, então
+ * basta uma passada: os inícios de cada grupo saem da contagem e cada índice vai
+ * direto para o seu lugar. Nenhum Componente é copiado e não há comparações.
+ * @param indices Vetor com espaço para inv->total posições.
+ * @return 1 (a operação não falha).
+ */
+int countingSortIndicesPorPrioridade(const Inventario *inv, int indices[], long long *comparacoes, Movimentacao *movimentacao) {
+    int proxima[FAIXA_PRIORIDADE];
+    int soma = 0;
+    for (int p = 0; p < FAIXA_PRIORIDADE; p++) {
+        proxima[p] = soma;
+        soma += inv->contagemPrioridade[p];
+    }
+    *comparacoes = 0;
+    zerarMovimentacao(movimentacao);
+    for (int i = 0; i < inv->total; i++) {
+        indices[proxima[inv->itens[i].prioridade - PRIORIDADE_MINIMA]++] = i;
+    }
+    contarMovimentos(movimentacao, inv->total, sizeof(int));
+    return 1;
+}
+
+/**
+ * @brief Leva para a posição k o componente que estava em ordem[k], copiando
+ * cada um uma única vez: segue cada ciclo da permutação, com só o primeiro do
+ * ciclo num temporário. 'ordem' marca as posições resolvidas e termina como a
+ * identidade.
+ */
+static void aplicarPermutacao(Componente componentes[], int ordem[], int total, Movimentacao *movimentacao) {
+    long long movidos = 0;
+    for (int inicio = 0; inicio < total; inicio++) {
+        if (ordem[inicio] == inicio) continue;
+        Componente temp = componentes[inicio];
+        int k = inicio;
+        while (ordem[k] != inicio) {
+            int origem = ordem[k];
+            componentes[k] = componentes[origem];
+            ordem[k] = k;
+            k = origem;
+            movidos++;
+        }
+        componentes[k] = temp;
+        ordem[k] = k;
+        movidos += 2; // entrada e saída do temporário
+    }
+    contarMovimentos(movimentacao, movidos, sizeof(Componente));
+}
+
+/**
+ * @brief Ordena sem mover componentes durante a ordenação: ordena uma
+ * permutação e só no fim a aplica, copiando cada componente uma vez (contra
+ * cerca de 2 n log n cópias de 56 bytes no Merge Sort). Por prioridade a chave
+ * cabe num inteiro, então são ordenados pares (prioridade, posição) de 8 bytes
+ * sem ler o vetor; nos outros critérios, posições de 4 bytes comparadas pelo
+ * componente a que apontam. Estável.
+ * @return 1 se deu certo, 0 se faltou memória (o vetor fica como estava).
+ */
+int ordenarPorPermutacao(Componente componentes[], int total, int criterio, long long *comparacoes, Movimentacao *movimentacao) {
+    *comparacoes = 0;
+    zerarMovimentacao(movimentacao);
+    if (total < 2) return 1;
+    int *ordem = (int*) malloc((size_t) total * sizeof(int));
+    if (ordem == NULL) return 0;
+    if (criterio == CRITERIO_PRIORIDADE) {
+        // Prioridade nos 32 bits altos, posição nos baixos: os pares são todos
+        // distintos, então a ordem deles já é a estável.
+        uint64_t *pares = (uint64_t*) malloc(2 * (size_t) total * sizeof(uint64_t));
+        if (pares == NULL) {
+            free(ordem);
+            return 0;
+        }
+        for (int i = 0; i < total; i++) pares[i] = (uint64_t) (uint32_t) componentes[i].prioridade << 32 | (uint32_t) i;
+        contarMovimentos(movimentacao, total, sizeof(uint64_t));
+        mergeSortChavesFaixa(pares, pares + total, 0, total, [](uint64_t a, uint64_t b) { return a < b; }, comparacoes, movimentacao);
+        for (int i = 0; i < total; i++) ordem[i] = (int) (uint32_t) pares[i];
+        contarMovimentos(movimentacao, total, sizeof(int));
+        free(pares);
+    } else {
+        int *auxiliar = (int*) malloc((size_t) total * sizeof(int));
+        if (auxiliar == NULL) {
+            free(ordem);
+            return 0;
+        }
+        for (int i = 0; i < total; i++) ordem[i] = i;
+        contarMovimentos(movimentacao, total, sizeof(int));
+        mergeSortIndicesFaixa(componentes, ordem, auxiliar, 0, total, comparadorDoCriterio(criterio), comparacoes, movimentacao);
+        free(auxiliar);
+    }
+    aplicarPermutacao(componentes, ordem, total, movimentacao);
+    free(ordem);
+    return 1;
+}
+
+/**
+ * @brief Nome do algoritmo para as mensagens do menu.
+ */
+const char *nomeDoAlgoritmo(int criterio, int algoritmo) {
+    static const char *originais[] = {"Bubble Sort", "Insertion Sort", "Selection Sort"};
+    switch (algoritmo) {
+        case ALGORITMO_INTROSORT: return "Introsort";
+        case ALGORITMO_MERGESORT: return "Merge Sort";
+        case ALGORITMO_COUNTING: return "Counting Sort";
+        case ALGORITMO_PERMUTACAO: return criterio == CRITERIO_PRIORIDADE ? "Permutacao (pares chave/indice)" : "Permutacao (indices)";
+        default: return originais[criterio];
+    }
+}
+
+/**
+ * @brief Reordena o vetor pelo critério com o algoritmo escolhido no menu.
+ * ALGORITMO_ORIGINAL usa o algoritmo quadrático que o menu sempre usou para o
+ * critério, para comparar os contadores lado a lado. ALGORITMO_COUNTING não
+ * move o vetor: ver countingSortIndicesPorPrioridade.
+ * @return 1 se deu certo, 0 se faltou memória ou a combinação não existe.
+ */
+int ordenarComponentes(Componente componentes[], int total, int criterio, int algoritmo, long long *comparacoes, Movimentacao *movimentacao) {
+    switch (algoritmo) {
+        case ALGORITMO_INTROSORT:
+            introsortComponentes(componentes, total, comparadorDoCriterio(criterio), comparacoes, movimentacao);
+            return 1;
+        case ALGORITMO_MERGESORT:
+            return mergeSortComponentes(componentes, total, comparadorDoCriterio(criterio), comparacoes, movimentacao);
+        case ALGORITMO_ORIGINAL:
+            if (criterio == CRITERIO_NOME) bubbleSortPorNome(componentes, total, comparacoes, movimentacao);
+            else if (criterio == CRITERIO_TIPO) insertionSortPorTipo(componentes, total, comparacoes, movimentacao);
+            else selectionSortPorPrioridade(componentes, total, comparacoes, movimentacao);
+            return 1;
+        case ALGORITMO_PERMUTACAO:
+            return ordenarPorPermutacao(componentes, total, criterio, comparacoes, movimentacao);
+    }
+    return 0;
+}
+
+
+// --- Implementação dos Algoritmos de Busca ---
+
+/**
+ * @brief Busca um componente pelo nome de forma sequencial.
+ */
+int buscaSequencialPorNome(const Componente componentes[], int total, const char *nomeBuscado, int *comparacoes) {
+    *comparacoes = 0;
+    for (int i = 0; i < total; i++) {
+        (*comparacoes)++;
+        if (strcmp(componentes[i].nome, nomeBuscado) == 0) {
+            return i; // Retorna o índice onde encontrou
+        }
+    }
+    return -1; // Retorna -1 se não encontrou
+}
+
+/**
+ * @brief Busca sequencial com o vetor dividido em faixas, uma por thread. Quem
+ * acha o nome anota a posição; as threads que estão depois dela param (de vez
+ * em quando olham a posição anotada), e as de antes continuam, porque a
+ * resposta é a primeira ocorrência, como na busca sequencial.
+ * @param comparacoes Soma das comparações feitas por todas as threads.
+ * @return A posição do componente, ou -1.
+ */
+int buscaSequencialParalela(const Componente componentes[], int total, const char *nomeBuscado, int threads, int *comparacoes) {
+    threads = limitarThreads(threads, total);
+    std::atomic<int> achado(total); // total = ainda não achou
+    std::vector<int> contagem(threads, 0);
+    executarEmParalelo(threads, [&](int t) {
+        int inicio = (int) ((long long) total * t / threads);
+        int fim = (int) ((long long) total * (t + 1) / threads);
+        int feitas = 0; // local: contagem[t] e contagem[t + 1] dividem a linha de cache
+        for (int i = inicio; i < fim; i++) {
+            if ((i & 1023) == 0 && achado.load(std::memory_order_relaxed) < i) break;
+            feitas++;
+            if (strcmp(componentes[i].nome, nomeBuscado) == 0) {
+                int atual = achado.load();
+                while (i < atual && !achado.compare_exchange_weak(atual, i)) {}
+                break;
+            }
+        }
+        contagem[t] = feitas;
+    });
+    *comparacoes = 0;
+    for (int t = 0; t < threads; t++) *comparacoes += contagem[t];
+    return achado.load() < total ? achado.load() : -1;
+}
+
+/**
+ * @brief Busca um componente pelo nome percorrendo o índice ordenado por nome.
+ * @return A posição do componente no vetor, ou -1.
+ */
+int buscaBinariaPorNome(const Componente componentes[], const int ordemPorNome[], int total, const char *nomeBuscado, int *comparacoes) {
+    *comparacoes = 0;
+    int esquerda = 0, direita = total - 1;
+    while (esquerda <= direita) {
+        (*comparacoes)++;
+        int meio = esquerda + (direita - esquerda) / 2;
+        int res = strcmp(nomeBuscado, componentes[ordemPorNome[meio]].nome);
+
+        if (res == 0) return ordemPorNome[meio]; // Encontrou
+        if (res > 0) esquerda = meio + 1; // Busca na metade direita
+        else direita = meio - 1; // Busca na metade esquerda
+    }
+    return -1; // Não encontrou
+}
+
+/**
+ * @brief Busca um nome exato na tabela de nomes. Conta uma comparação por
+ * nome examinado na sondagem (normalmente um ou dois).
+ * @return A primeira posição com esse nome no vetor, ou -1.
+ */
+int buscaHashPorNome(const Inventario *inv, const char *nomeBuscado, int *comparacoes) {
+    *comparacoes = 0;
+    uint32_t mascara = (uint32_t) inv->capacidadeTabela - 1;
+    for (uint32_t i = hashNome(nomeBuscado) & mascara; inv->tabelaNomes[i] != -1; i = (i + 1) & mascara) {
+        (*comparacoes)++;
+        if (strcmp(inv->itens[inv->tabelaNomes[i]].nome, nomeBuscado) == 0) return inv->tabelaNomes[i];
+    }
+    return -1;
+}
+
+/**
+ * @brief Acha, no índice por nome, a faixa dos componentes cujo nome começa com
+ * 'prefixo' (autocompletar): duas buscas binárias, uma para cada ponta.
+ * @param primeiro Recebe onde a faixa começa em inv->ordem[CRITERIO_NOME].
+ * @return Quantos componentes há na faixa.
+ */
+int buscaPorPrefixo(const Inventario *inv, const char *prefixo, int *primeiro, int *comparacoes) {
+    const int *ordem = inv->ordem[CRITERIO_NOME];
+    size_t tamanho = strlen(prefixo);
+    *comparacoes = 0;
+    // Primeiro nome >= prefixo.
+    int esquerda = 0, direita = inv->total;
+    while (esquerda < direita) {
+        int meio = esquerda + (direita - esquerda) / 2;
+        (*comparacoes)++;
+        if (strcmp(inv->itens[ordem[meio]].nome, prefixo) < 0) esquerda = meio + 1;
+        else direita = meio;
+    }
+    *primeiro = esquerda;
+    // Primeiro nome que já não começa com o prefixo.
+    direita = inv->total;
+    while (esquerda < direita) {
+        int meio = esquerda + (direita - esquerda) / 2;
+        (*comparacoes)++;
+        if (strncmp(inv->itens[ordem[meio]].nome, prefixo, tamanho) <= 0) esquerda = meio + 1;
+        else direita = meio;
+    }
+    return esquerda - *primeiro;
+}
+
+
+// --- Implementação da Varredura em Colunas ---
+
+/**
+ * @brief Id do tipo nas colunas, ou -1 se nenhum componente tem esse tipo.
+ */
+int idDoTipo(const ColunasInventario *col, const char *tipo) {
+    for (int id = 0; id < col->numTipos; id++) {
+        if (strcmp(col->nomesTipos[id], tipo) == 0) return id;
+    }
+    return col->numTipos == MAX_TIPOS ? TIPO_OUTROS : -1;
+}
+
+/**
+ * @brief Posições em [inicio, total) com prioridade >= minima e tipo == 'tipo',
+ * um componente por vez.
+ * @return Quantas posições foram escritas em 'saida'.
+ */
+int filtrarColunasEscalar(const ColunasInventario *col, int inicio, int total, int minima, int tipo, int saida[]) {
+    int encontrados = 0;
+    for (int i = inicio; i < total; i++) {
+        saida[encontrados] = i;
+        encontrados += col->prioridades[i] >= minima && col->tipos[i] == tipo; // sem desvio
+    }
+    return encontrados;
+}
+
+/**
+ * @brief Mesma varredura de filtrarColunasEscalar sobre [0, total), mas com SSE2
+ * testa 16 componentes por instrução; as posições que passaram saem da máscara
+ * de bits. O resto (menos de 16) vai pela versão escalar.
+ */
+int filtrarColunas(const ColunasInventario *col, int total, int minima, int tipo, int saida[]) {
+    int encontrados = 0, i = 0;
+#ifdef __SSE2__
+    const __m128i limite = _mm_set1_epi8((char) minima);
+    const __m128i alvo = _mm_set1_epi8((char) tipo);
+    for (; i + 16 <= total; i += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i*) (col->prioridades + i));
+        __m128i t = _mm_loadu_si128((const __m128i*) (col->tipos + i));
+        // p >= minima (sem sinal) equivale a max(p, minima) == p
+        __m128i passou = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(p, limite), p), _mm_cmpeq_epi8(t, alvo));
+        unsigned mascara = (unsigned) _mm_movemask_epi8(passou);
+        for (int b = 0; mascara != 0; b++, mascara >>= 1) {
+            saida[encontrados] = i + b;
+            encontrados += mascara & 1;
+        }
+    }
+#endif
+    return encontrados + filtrarColunasEscalar(col, i, total, minima, tipo, saida + encontrados);
+}
+
+/**
+ * @brief Posições dos componentes com prioridade >= minima e do tipo dado,
+ * em ordem, usando as colunas.
+ * @param saida Espaço para inv->total posições.
+ * @return Quantos componentes passaram.
+ */
+int filtrarPorPrioridadeETipo(const Inventario *inv, int minima, const char *tipo, int saida[]) {
+    int id = idDoTipo(&inv->colunas, tipo);
+    if (id < 0) return 0;
+    if (minima < 0) minima = 0;
+    if (minima > PRIORIDADE_MAXIMA) return 0;
+    int encontrados = filtrarColunas(&inv->colunas, inv->total, minima, id, saida);
+    if (id != TIPO_OUTROS) return encontrados;
+    // TIPO_OUTROS junta vários tipos: confere o nome do tipo de cada candidato.
+    int n = 0;
+    for (int k = 0; k < encontrados; k++) {
+        if (strcmp(inv->itens[saida[k]].tipo, tipo) == 0) saida[n++] = saida[k];
+    }
+    return n;
+}
+
+/**
+ * @brief A mesma consulta direto no vetor de componentes, registro a registro.
+ */
+int filtrarComponentes(const Componente componentes[], int total, int minima, const char *tipo, int saida[]) {
+    int encontrados = 0;
+    for (int i = 0; i < total; i++) {
+        if (componentes[i].prioridade >= minima && strcmp(componentes[i].tipo, tipo) == 0) saida[encontrados++] = i;
+    }
+    return encontrados;
+}
+
+static long long agoraNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int threadsDisponiveis() {
+    int n = (int) std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+// Threads que vale a pena usar com 'total' componentes: ao menos MINIMO_POR_THREAD para cada uma.
+int limitarThreads(int threads, int total) {
+    if (threads > total / MINIMO_POR_THREAD) threads = total / MINIMO_POR_THREAD;
+    return threads > 0 ? threads : 1;
+}
+
+/**
+ * @brief Compara a varredura "prioridade >= 7 e tipo == propulsao" no vetor de
+ * componentes e nas colunas (escalar e SSE2) com 'total' componentes gerados.
+ * Cada varredura é repetida até somar uns 200 milhões de componentes lidos.
+ */
+void benchmarkColunas(int total) {
+    Inventario inv;
+    if (total <= 0 || !inicializarInventario(&inv) || !gerarComponentes(&inv, total, 1)) {
+        printf("Erro: memoria insuficiente.\n");
+        return;
+    }
+    int *saida = (int*) malloc((size_t) total * sizeof(int));
+    if (saida == NULL) {
+        printf("Erro: memoria insuficiente.\n");
+        liberarInventario(&inv);
+        return;
+    }
+    const int minima = 7;
+    const char *tipo = "propulsao";
+    int id = idDoTipo(&inv.colunas, tipo);
+    int repeticoes = 200000000 / total > 0 ? 200000000 / total : 1;
+    const char *nomes[] = {"vetor de componentes", "colunas (escalar)", "colunas (SSE2)"};
+    size_t bytesPorLinha[] = {sizeof(Componente), 2, 2};
+#ifndef __SSE2__
+    nomes[2] = "colunas (sem SSE2)";
+#endif
+    printf("%d componentes, %d repeticoes, prioridade >= %d e tipo == %s\n", total, repeticoes, minima, tipo);
+    for (int modo = 0; modo < 3; modo++) {
+        int encontrados = 0;
+        long long inicio = agoraNs();
+        for (int r = 0; r < repeticoes; r++) {
+            if (modo == 0) encontrados = filtrarComponentes(inv.itens, total, minima, tipo, saida);
+            else if (modo == 1) encontrados = filtrarColunasEscalar(&inv.colunas, 0, total, minima, id, saida);
+            else encontrados = filtrarColunas(&inv.colunas, total, minima, id, saida);
+        }
+        double segundos = (agoraNs() - inicio) / 1e9;
+        printf("%-22s %8.3f ms/varredura  %7.0f M componentes/s  %2zu bytes/componente  (%d encontrados)\n",
+               nomes[modo], segundos * 1000 / repeticoes, (double) total * repeticoes / segundos / 1e6,
+               bytesPorLinha[modo], encontrados);
+    }
+    free(saida);
+    liberarInventario(&inv);
+}
+
+/**
+ * @brief Escalabilidade do Merge Sort paralelo (por nome) e da busca sequencial
+ * paralela, de 1 thread até 'maxThreads' (dobrando, e o máximo no fim), com
+ * 'total' componentes gerados. A busca procura um nome que não existe, o pior
+ * caso, e um que está perto do fim do vetor.
+ */
+void benchmarkParalelo(int total, int maxThreads) {
+    Inventario inv;
+    if (total <= 0 || !inicializarInventario(&inv) || !gerarComponentes(&inv, total, 1)) {
+        printf("Erro: memoria insuficiente.\n");
+        return;
+    }
+    Componente *copia = (Componente*) malloc((size_t) total * sizeof(Componente));
+    Componente *referencia = (Componente*) malloc((size_t) total * sizeof(Componente));
+    if (copia == NULL || referencia == NULL) {
+        printf("Erro: memoria insuficiente.\n");
+        free(copia);
+        free(referencia);
+        liberarInventario(&inv);
+        return;
+    }
+    char perto_do_fim[30];
+    strcpy(perto_do_fim, inv.itens[total - 1 - total / 10].nome);
+    printf("%d componentes, %d nucleos disponiveis\n", total, threadsDisponiveis());
+    printf("%-8s %14s %8s %16s %14s %14s\n", "threads", "ordenar (ms)", "ganho", "comparacoes", "ausente (ms)", "perto fim (ms)");
+    double base = 0;
+    for (int threads = 1;; threads = threads * 2 < maxThreads ? threads * 2 : maxThreads) {
+        long long comparacoes;
+        Movimentacao movimentacao;
+        memcpy(copia, inv.itens, (size_t) total * sizeof(Componente));
+        long long inicio = agoraNs();
+        int usadas = mergeSortParalelo(copia, total, compararPorNome, threads, &comparacoes, &movimentacao);
+        double ordenar = (agoraNs() - inicio) / 1e6;
+        if (usadas == 0) break;
+        if (threads == 1) {
+            base = ordenar;
+            memcpy(referencia, copia, (size_t) total * sizeof(Componente));
+        } else if (memcmp(referencia, copia, (size_t) total * sizeof(Componente)) != 0) {
+            printf("ERRO: ordem diferente da ordenacao com 1 thread\n");
+        }
+        int comparacoesBusca;
+        inicio = agoraNs();
+        buscaSequencialParalela(inv.itens, total, "nao existe", threads, &comparacoesBusca);
+        double ausente = (agoraNs() - inicio) / 1e6;
+        inicio = agoraNs();
+        buscaSequencialParalela(inv.itens, total, perto_do_fim, threads, &comparacoesBusca);
+        double pertoFim = (agoraNs() - inicio) / 1e6;
+        printf("%-8d %14.2f %7.2fx %16lld %14.2f %14.2f\n", usadas, ordenar, base / ordenar, comparacoes, ausente, pertoFim);
+        if (threads >= maxThreads) break;
+    }
+    free(copia);
+    free(referencia);
+    liberarInventario(&inv);
+}
+
+
+// --- Benchmark das Ordenações e Buscas ---
+
+/**
+ * @brief Abre o contador de falhas de cache do processador (perf_event_open),
+ * que também conta as threads criadas depois. Começa desligado.
+ * @return O descritor, ou -1 se o sistema não oferece (ou não permite).
+ */
+static int abrirContadorCache() {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static void ligarContadorCache(int contador, int ligar) {
+#ifdef __linux__
+    if (contador >= 0) ioctl(contador, ligar ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+#else
+    (void) contador;
+    (void) ligar;
+#endif
+}
+
+static long long lerContadorCache(int contador) {
+    long long valor = 0;
+    if (contador < 0 || read(contador, &valor, sizeof(valor)) != (long) sizeof(valor)) return -1;
+    return valor;
+}
+
+/**
+ * @brief Mede uma operação: AQUECIMENTO execuções descartadas e depois
+ * r->repeticoes execuções cronometradas uma a uma. 'preparar' restaura a
+ * entrada e fica fora do tempo; 'executar' recebe onde contar as cópias e
+ * devolve as comparações feitas.
+ */
+template <typename Preparar, typename Executar>
+static void medir(ResultadoBenchmark *r, int contador, Preparar preparar, Executar executar) {
+    std::vector<long long> tempos(r->repeticoes);
+    for (int i = 0; i < AQUECIMENTO; i++) {
+        preparar();
+        executar(&r->movimentacao);
+    }
+    long long antes = lerContadorCache(contador);
+    for (int i = 0; i < r->repeticoes; i++) {
+        preparar();
+        zerarMovimentacao(&r->movimentacao);
+        ligarContadorCache(contador, 1);
+        long long inicio = agoraNs();
+        r->comparacoes = executar(&r->movimentacao);
+        tempos[i] = agoraNs() - inicio;
+        ligarContadorCache(contador, 0);
+    }
+    long long depois = lerContadorCache(contador);
+    std::sort(tempos.begin(), tempos.end());
+    r->medianaNs = tempos[r->repeticoes / 2];
+    r->p95Ns = tempos[(r->repeticoes * 95 + 99) / 100 - 1];
+    r->falhasCache = antes >= 0 && depois >= 0 ? (depois - antes) / r->repeticoes : -1;
+}
+
+// Imprime uma linha do relatório; '*primeiro' diz se ainda falta o cabeçalho.
+static void imprimirResultado(const ResultadoBenchmark *r, int formato, int *primeiro) {
+    int cabecalho = *primeiro;
+    *primeiro = 0;
+    if (formato == FORMATO_CSV) {
+        if (cabecalho) printf("distribuicao,tamanho,operacao,algoritmo,repeticoes,mediana_ns,p95_ns,comparacoes,movimentos,bytes_copiados,falhas_cache\n");
+        printf("%s,%d,%s,%s,%d,%lld,%lld,%lld,%lld,%lld,", r->distribuicao, r->tamanho, r->operacao, r->algoritmo,
+               r->repeticoes, r->medianaNs, r->p95Ns, r->comparacoes, r->movimentacao.elementos, r->movimentacao.bytes);
+        if (r->falhasCache >= 0) printf("%lld", r->falhasCache);
+        printf("\n");
+        return;
+    }
+    printf("%s  {\"distribuicao\": \"%s\", \"tamanho\": %d, \"operacao\": \"%s\", \"algoritmo\": \"%s\", "
+           "\"repeticoes\": %d, \"mediana_ns\": %lld, \"p95_ns\": %lld, \"comparacoes\": %lld, \"movimentos\": %lld, "
+           "\"bytes_copiados\": %lld, \"falhas_cache\": ",
+           cabecalho ? "[\n" : ",\n", r->distribuicao, r->tamanho, r->operacao, r->algoritmo,
+           r->repeticoes, r->medianaNs, r->p95Ns, r->comparacoes, r->movimentacao.elementos, r->movimentacao.bytes);
+    if (r->falhasCache >= 0) printf("%lld}", r->falhasCache);
+    else printf("null}");
+}
+
+/**
+ * @brief Preenche 'v' com 'n' componentes na distribuição pedida; as
+ * distribuições ordenada e invertida seguem a chave do critério.
+ */
+static void gerarDistribuicao(Componente v[], int n, int distribuicao, int criterio, unsigned int semente) {
+    uint64_t estado = semente;
+    for (int i = 0; i < n; i++) sortearComponente(&estado, distribuicao == DIST_REPETIDOS ? 16u : 100000000u, &v[i]);
+    if (distribuicao == DIST_ORDENADA || distribuicao == DIST_INVERTIDA) {
+        long long comparacoes;
+        Movimentacao movimentacao;
+        mergeSortComponentes(v, n, comparadorDoCriterio(criterio), &comparacoes, &movimentacao);
+    }
+    if (distribuicao == DIST_INVERTIDA) std::reverse(v, v + n);
+}
+
+/**
+ * @brief Roda todas as ordenações (para cada critério) e buscas por nome em
+ * cada distribuição e em cada tamanho da lista "1000,10000,...", e imprime o
+ * relatório em CSV ou JSON na saída padrão.
+ */
+void benchmarkAlgoritmos(const char *tamanhos, int repeticoes, int formato) {
+    static const char *nomesDistribuicao[] = {"aleatoria", "ordenada", "invertida", "repetidos"};
+    static const char *operacoes[] = {"ordenar por nome", "ordenar por tipo", "ordenar por prioridade"};
+    int contador = abrirContadorCache();
+    int threads = threadsDisponiveis();
+    int primeiro = 1;
+    ResultadoBenchmark r;
+    r.repeticoes = repeticoes;
+
+    for (const char *p = tamanhos; *p; ) {
+        int n = atoi(p);
+        p += strcspn(p, ",");
+        if (*p == ',') p++;
+        if (n <= 0) continue;
+        r.tamanho = n;
+        Componente *entrada = (Componente*) malloc((size_t) n * sizeof(Componente));
+        Componente *v = (Componente*) malloc((size_t) n * sizeof(Componente));
+        int *indices = (int*) malloc((size_t) n * sizeof(int));
+        if (entrada == NULL || v == NULL || indices == NULL) {
+            fprintf(stderr, "Erro: memoria insuficiente para %d componentes.\n", n);
+            free(entrada);
+            free(v);
+            free(indices);
+            return;
+        }
+        for (int d = 0; d < NUM_DISTRIBUICOES; d++) {
+            r.distribuicao = nomesDistribuicao[d];
+
+            // --- Ordenações ---
+            for (int criterio = CRITERIO_NOME; criterio <= CRITERIO_PRIORIDADE; criterio++) {
+                ComparadorComponente comparar = comparadorDoCriterio(criterio);
+                gerarDistribuicao(entrada, n, d, criterio, (unsigned int) n);
+                auto restaurar = [&]() { memcpy(v, entrada, (size_t) n * sizeof(Componente)); };
+                r.operacao = operacoes[criterio];
+                for (int algoritmo = ALGORITMO_INTROSORT; algoritmo <= ALGORITMO_PERMUTACAO; algoritmo++) {
+                    if (algoritmo == ALGORITMO_COUNTING) continue; // medido abaixo, sobre um inventário
+                    if (algoritmo == ALGORITMO_ORIGINAL && n > LIMITE_QUADRATICO) continue;
+                    r.algoritmo = nomeDoAlgoritmo(criterio, algoritmo);
+                    medir(&r, contador, restaurar, [&](Movimentacao *movimentacao) {
+                        long long comparacoes = 0;
+                        ordenarComponentes(v, n, criterio, algoritmo, &comparacoes, movimentacao);
+                        return comparacoes;
+                    });
+                    imprimirResultado(&r, formato, &primeiro);
+                }
+                r.algoritmo = "Merge Sort paralelo";
+                medir(&r, contador, restaurar, [&](Movimentacao *movimentacao) {
+                    long long comparacoes = 0;
+                    mergeSortParalelo(v, n, comparar, threads, &comparacoes, movimentacao);
+                    return comparacoes;
+                });
+                imprimirResultado(&r, formato, &primeiro);
+            }
+
+            // --- Counting Sort e buscas, sobre um inventário com os índices prontos ---
+            Inventario inv;
+            gerarDistribuicao(entrada, n, d, CRITERIO_NOME, (unsigned int) n);
+            if (!inicializarInventario(&inv)) {
+                liberarInventario(&inv);
+                continue;
+            }
+            int carregou = 1;
+            for (int i = 0; i < n && carregou; i++) carregou = guardarComponente(&inv, &entrada[i]);
+            if (!carregou || !reconstruirIndices(&inv)) {
+                liberarInventario(&inv);
+                continue;
+            }
+            auto nada = []() {};
+            r.operacao = operacoes[CRITERIO_PRIORIDADE];
+            r.algoritmo = "Counting Sort (indices)";
+            medir(&r, contador, nada, [&](Movimentacao *movimentacao) {
+                long long comparacoes = 0;
+                countingSortIndicesPorPrioridade(&inv, indices, &comparacoes, movimentacao);
+                return comparacoes;
+            });
+            imprimirResultado(&r, formato, &primeiro);
+
+            // Metade das consultas são nomes que existem, a outra metade não.
+            char consultas[CONSULTAS_BUSCA][30];
+            for (int q = 0; q < CONSULTAS_BUSCA; q++) {
+                if (q % 2 == 0) strcpy(consultas[q], entrada[(int) ((long long) q * 7919 % n)].nome);
+                else snprintf(consultas[q], sizeof(consultas[q]), "Ausente-%d", q);
+            }
+            r.operacao = "buscar por nome (200 consultas)";
+            static const char *nomesBusca[] = {"Sequencial", "Binaria (indice)", "Hash", "Sequencial paralela"};
+            for (int tipoBusca = 0; tipoBusca < 4; tipoBusca++) {
+                r.algoritmo = nomesBusca[tipoBusca];
+                medir(&r, contador, nada, [&](Movimentacao *) {
+                    long long comparacoes = 0;
+                    for (int q = 0; q < CONSULTAS_BUSCA; q++) {
+                        int c = 0;
+                        if (tipoBusca == 0) buscaSequencialPorNome(inv.itens, n, consultas[q], &c);
+                        else if (tipoBusca == 1) buscaBinariaPorNome(inv.itens, inv.ordem[CRITERIO_NOME], n, consultas[q], &c);
+                        else if (tipoBusca == 2) buscaHashPorNome(&inv, consultas[q], &c);
+                        else buscaSequencialParalela(inv.itens, n, consultas[q], threads, &c);
+                        comparacoes += c;
+                    }
+                    return comparacoes;
+                });
+                imprimirResultado(&r, formato, &primeiro);
+            }
+            liberarInventario(&inv);
+        }
+        free(entrada);
+        free(v);
+        free(indices);
+    }
+    if (formato == FORMATO_JSON) printf(primeiro ? "[]\n" : "\n]\n");
+    if (contador >= 0) close(contador);
+}
+
+
+// --- Implementação da Importação e dos Snapshots ---
+
+/**
+ * @brief Deixa o arquivo inteiro acessível em memória, sem copiá-lo: com mmap
+ * as páginas só são lidas do disco quando tocadas. Pode-se escrever no
+ * mapeamento: a página alterada vira uma cópia só deste processo.
+ * @return 1 se deu certo, 0 se não foi possível abrir ou ler.
+ */
+static int mapearArquivo(const char *arquivo, ArquivoMapeado *a) {
+    a->dados = NULL;
+    a->tamanho = 0;
+    a->mapeado = 0;
+#ifndef _WIN32
+    int fd = open(arquivo, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return 0;
+    }
+    a->tamanho = (size_t) info.st_size;
+    if (a->tamanho == 0) {
+        close(fd);
+        return 1; // nada para mapear
+    }
+    void *base = mmap(NULL, a->tamanho, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+    madvise(base, a->tamanho, MADV_SEQUENTIAL);
+    a->dados = (char*) base;
+    a->mapeado = 1;
+    return 1;
+#else
+    FILE *f = fopen(arquivo, "rb");
+    if (f == NULL) return 0;
+    fseek(f, 0, SEEK_END);
+    long tamanho = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *dados = (char*) malloc(tamanho > 0 ? (size_t) tamanho : 1);
+    if (dados == NULL || (tamanho > 0 && fread(dados, 1, (size_t) tamanho, f) != (size_t) tamanho)) {
+        free(dados);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    a->dados = dados;
+    a->tamanho = (size_t) tamanho;
+    return 1;
+#endif
+}
+
+static void desmapearArquivo(ArquivoMapeado *a) {
+#ifndef _WIN32
+    if (a->mapeado) munmap(a->dados, a->tamanho);
+#else
+    free(a->dados);
+#endif
+    a->dados = NULL;
+    a->tamanho = 0;
+    a->mapeado = 0;
+}
+
+/**
+ * @brief Lê uma linha "nome,tipo,prioridade" (sem o '\n') direto do buffer.
+ * O nome pode ter vírgulas: tipo e prioridade são os dois últimos campos, e por
+ * isso o tipo não pode ter (cadastrarComponente também recusa).
+ * @return 1 se a linha é válida, 0 se não.
+ */
+static int lerLinhaCSV(const char *inicio, const char *fim, Componente *c) {
+    const char *virgula2 = fim;
+    while (virgula2 > inicio && virgula2[-1] != ',') virgula2--;
+    if (virgula2 == inicio) return 0;
+    const char *virgula1 = virgula2 - 1;
+    while (virgula1 > inicio && virgula1[-1] != ',') virgula1--;
+    if (virgula1 == inicio) return 0;
+    size_t tamanhoNome = (size_t) (virgula1 - 1 - inicio), tamanhoTipo = (size_t) (virgula2 - 1 - virgula1);
+    if (tamanhoNome == 0 || tamanhoNome >= sizeof(c->nome) || tamanhoTipo == 0 || tamanhoTipo >= sizeof(c->tipo)) return 0;
+    int prioridade = 0;
+    if (virgula2 == fim || fim - virgula2 > 2) return 0;
+    for (const char *p = virgula2; p < fim; p++) {
+        if (*p < '0' || *p > '9') return 0;
+        prioridade = prioridade * 10 + (*p - '0');
+    }
+    if (prioridade < PRIORIDADE_MINIMA || prioridade > PRIORIDADE_MAXIMA) return 0;
+    memset(c, 0, sizeof(*c));
+    memcpy(c->nome, inicio, tamanhoNome);
+    memcpy(c->tipo, virgula1, tamanhoTipo);
+    c->prioridade = prioridade;
+    return 1;
+}
+
+/**
+ * @brief Acrescenta ao inventário os componentes de um CSV "nome,tipo,prioridade"
+ * (cabeçalho opcional, linhas terminadas em \n ou \r\n). O arquivo é mapeado e
+ * percorrido uma vez com memchr, sem scanf nem cópia de linhas; os índices
+ * ordenados são refeitos uma vez no final.
+ * @param rejeitadas Recebe quantas linhas não vazias foram ignoradas por inválidas.
+ * @return Quantos componentes entraram, ou -1 se o arquivo não pôde ser lido.
+ */
+int importarCSV(Inventario *inv, const char *arquivo, int *rejeitadas) {
+    ArquivoMapeado a;
+    *rejeitadas = 0;
+    if (!mapearArquivo(arquivo, &a)) return -1;
+    const char *p = a.dados, *fimArquivo = a.dados + a.tamanho;
+    int antes = inv->total, linha = 0;
+    while (p < fimArquivo) {
+        const char *quebra = (const char*) memchr(p, '\n', (size_t) (fimArquivo - p));
+        const char *fimLinha = quebra ? quebra : fimArquivo;
+        const char *proxima = quebra ? quebra + 1 : fimArquivo;
+        if (fimLinha > p && fimLinha[-1] == '\r') fimLinha--;
+        linha++;
+        Componente c;
+        if (fimLinha == p) {
+            // linha vazia
+        } else if (lerLinhaCSV(p, fimLinha, &c)) {
+            if (!guardarComponente(inv, &c)) break; // sem memória: fica o que já entrou
+        } else if (!(linha == 1 && fimLinha - p >= 5 && memcmp(p, "nome,", 5) == 0)) {
+            (*rejeitadas)++;
+        }
+        p = proxima;
+    }
+    desmapearArquivo(&a);
+    reconstruirIndices(inv);
+    return inv->total - antes;
+}
+
+/**
+ * @brief Grava o inventário em CSV, no formato que importarCSV lê.
+ * @return 1 se deu certo, 0 se não.
+ */
+int exportarCSV(const Inventario *inv, const char *arquivo) {
+    FILE *f = fopen(arquivo, "w");
+    if (f == NULL) return 0;
+    setvbuf(f, NULL, _IOFBF, 1 << 20);
+    fprintf(f, "nome,tipo,prioridade\n");
+    for (int i = 0; i < inv->total; i++) {
+        fprintf(f, "%s,%s,%d\n", inv->itens[i].nome, inv->itens[i].tipo, inv->itens[i].prioridade);
+    }
+    // Um fprintf que falhou no meio do arquivo fica marcado em ferror, não em fclose.
+    int erro = ferror(f);
+    return fclose(f) == 0 && !erro;
+}
+
+/**
+ * @brief Tamanho de cada seção do snapshot, na ordem em que são gravadas, e o
+ * deslocamento de cada uma a partir do início do arquivo.
+ * @return O tamanho total do arquivo.
+ */
+static size_t secoesSnapshot(const CabecalhoSnapshot *c, size_t deslocamento[], size_t tamanho[]) {
+    size_t n = (size_t) c->total;
+    int s = 0;
+    tamanho[s++] = n * sizeof(Componente);
+    for (int k = 0; k < NUM_CRITERIOS; k++) tamanho[s++] = n * sizeof(int);
+    tamanho[s++] = (size_t) c->capacidadeTabela * sizeof(int);
+    tamanho[s++] = n;                               // prioridades
+    tamanho[s++] = n;                               // tipos
+    tamanho[s++] = n * sizeof(uint32_t);            // inicioNome
+    tamanho[s++] = (size_t) c->tamanhoNomes;        // nomes
+    tamanho[s++] = sizeof(((ColunasInventario*) 0)->nomesTipos);
+    size_t posicao = sizeof(CabecalhoSnapshot);
+    for (s = 0; s < NUM_SECOES_SNAPSHOT; s++) {
+        posicao = (posicao + ALINHAMENTO_SECAO - 1) / ALINHAMENTO_SECAO * ALINHAMENTO_SECAO;
+        deslocamento[s] = posicao;
+        posicao += tamanho[s];
+    }
+    return posicao;
+}
+
+// Endereço de cada seção do snapshot dentro do inventário, na ordem de secoesSnapshot.
+static void enderecosSnapshot(const Inventario *inv, void *enderecos[]) {
+    int s = 0;
+    enderecos[s++] = inv->itens;
+    for (int k = 0; k < NUM_CRITERIOS; k++) enderecos[s++] = inv->ordem[k];
+    enderecos[s++] = inv->tabelaNomes;
+    enderecos[s++] = inv->colunas.prioridades;
+    enderecos[s++] = inv->colunas.tipos;
+    enderecos[s++] = inv->colunas.inicioNome;
+    enderecos[s++] = inv->colunas.nomes;
+    enderecos[s++] = (void*) inv->colunas.nomesTipos;
+}
+
+/**
+ * @brief Grava o inventário inteiro, com índices e colunas, num snapshot binário.
+ * A fila de montagem não é gravada: ao carregar, todos os componentes voltam a
+ * ela, como se tivessem acabado de ser cadastrados. O arquivo é escrito com
+ * outro nome e só no fim toma o lugar do antigo, que pode estar mapeado pelo
+ * próprio inventário.
+ * @return 1 se deu certo, 0 se não.
+ */
+int salvarSnapshot(const Inventario *inv, const char *arquivo) {
+    CabecalhoSnapshot c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.assinatura, SNAPSHOT_ASSINATURA, sizeof(c.assinatura));
+    c.versao = SNAPSHOT_VERSAO;
+    c.tamanhoComponente = sizeof(Componente);
+    c.total = inv->total;
+    c.capacidadeTabela = inv->capacidadeTabela;
+    c.tamanhoNomes = (int64_t) inv->colunas.tamanhoNomes;
+    c.numTipos = inv->colunas.numTipos;
+    size_t deslocamento[NUM_SECOES_SNAPSHOT], tamanho[NUM_SECOES_SNAPSHOT];
+    void *enderecos[NUM_SECOES_SNAPSHOT];
+    secoesSnapshot(&c, deslocamento, tamanho);
+    enderecosSnapshot(inv, enderecos);
+
+    char temporario[FILENAME_MAX];
+    if (snprintf(temporario, sizeof(temporario), "%s.tmp", arquivo) >= (int) sizeof(temporario)) return 0;
+    FILE *f = fopen(temporario, "wb");
+    if (f == NULL) return 0;
+    static const char zeros[ALINHAMENTO_SECAO] = {0};
+    int ok = fwrite(&c, sizeof(c), 1, f) == 1;
+    size_t posicao = sizeof(c);
+    for (int s = 0; s < NUM_SECOES_SNAPSHOT && ok; s++) {
+        ok = fwrite(zeros, 1, deslocamento[s] - posicao, f) == deslocamento[s] - posicao &&
+             fwrite(enderecos[s], 1, tamanho[s], f) == tamanho[s];
+        posicao = deslocamento[s] + tamanho[s];
+    }
+    ok = fclose(f) == 0 && ok;
+#ifdef _WIN32
+    if (ok) remove(arquivo); // no Windows rename não substitui um arquivo existente
+#endif
+    if (ok) ok = rename(temporario, arquivo) == 0;
+    if (!ok) remove(temporario);
+    return ok;
+}
+
+/**
+ * @brief Confere se o que veio do snapshot é coerente (posições e ids dentro
+ * dos limites), para um arquivo corrompido não virar acesso fora do vetor.
+ * Cada vetor é percorrido por inteiro, acumulando os erros num OU, sem desvio
+ * dentro do laço: assim o compilador vetoriza e a conferência custa pouco
+ * perto de ler o arquivo.
+ */
+static int snapshotCoerente(const Inventario *inv) {
+    const ColunasInventario *col = &inv->colunas;
+    if (col->numTipos < 0 || col->numTipos > MAX_TIPOS) return 0;
+    if (col->tamanhoNomes != 0 && col->nomes[col->tamanhoNomes - 1] != '\0') return 0;
+    unsigned fora = 0;
+    for (int i = 0; i < inv->total; i++) {
+        const Componente *c = &inv->itens[i];
+        fora |= (unsigned) (c->prioridade - PRIORIDADE_MINIMA) >= (unsigned) FAIXA_PRIORIDADE;
+        fora |= c->nome[sizeof(c->nome) - 1] != '\0' && memchr(c->nome, '\0', sizeof(c->nome)) == NULL;
+        fora |= c->tipo[sizeof(c->tipo) - 1] != '\0' && memchr(c->tipo, '\0', sizeof(c->tipo)) == NULL;
+    }
+    for (int i = 0; i < inv->total; i++) {
+        fora |= col->tipos[i] >= col->numTipos && col->tipos[i] != TIPO_OUTROS;
+        fora |= col->inicioNome[i] >= col->tamanhoNomes;
+    }
+    for (int k = 0; k < NUM_CRITERIOS; k++) {
+        for (int i = 0; i < inv->total; i++) fora |= (unsigned) inv->ordem[k][i] >= (unsigned) inv->total;
+    }
+    int livres = 0; // com menos espaços livres que o esperado, a sondagem poderia não parar
+    for (int i = 0; i < inv->capacidadeTabela; i++) {
+        fora |= inv->tabelaNomes[i] < -1 || inv->tabelaNomes[i] >= inv->total;
+        livres += inv->tabelaNomes[i] == -1;
+    }
+    return !fora && livres >= inv->capacidadeTabela - inv->total;
+}
+
+/**
+ * @brief Troca o conteúdo do inventário pelo de um snapshot salvo com
+ * salvarSnapshot. O arquivo fica mapeado e os vetores do inventário passam a
+ * apontar para as seções dele: nada é copiado, reordenado nem reindexado. A
+ * carga ainda custa uma passada sequencial pelo arquivo inteiro, porque
+ * snapshotCoerente confere todas as seções e a contagem por prioridade e a fila
+ * de montagem são refeitas com todos os itens. O primeiro vetor que precisar
+ * crescer é copiado para a memória normal (crescerBloco).
+ * @return 1 se deu certo, 0 se o arquivo não é um snapshot válido ou faltou
+ * memória (nesses casos o inventário não muda).
+ */
+int carregarSnapshot(Inventario *inv, const char *arquivo) {
+    Inventario novo;
+    memset(&novo, 0, sizeof(novo));
+    inicializarFilaMontagem(&novo.montagem);
+    if (!mapearArquivo(arquivo, &novo.snapshot)) return 0;
+    char *dados = novo.snapshot.dados;
+    CabecalhoSnapshot c;
+    size_t deslocamento[NUM_SECOES_SNAPSHOT], tamanho[NUM_SECOES_SNAPSHOT];
+    int ok = novo.snapshot.tamanho >= sizeof(c);
+    if (ok) {
+        memcpy(&c, dados, sizeof(c));
+        ok = memcmp(c.assinatura, SNAPSHOT_ASSINATURA, sizeof(c.assinatura)) == 0 &&
+             c.versao == SNAPSHOT_VERSAO && c.tamanhoComponente == sizeof(Componente) &&
+             c.total >= 0 && c.total < (1 << 30) && c.tamanhoNomes >= 0 && c.tamanhoNomes < ((int64_t) 1 << 32) &&
+             c.capacidadeTabela > 0 && c.capacidadeTabela >= 2 * c.total && c.capacidadeTabela < ((int64_t) 1 << 31) &&
+             (c.capacidadeTabela & (c.capacidadeTabela - 1)) == 0;
+    }
+    ok = ok && secoesSnapshot(&c, deslocamento, tamanho) <= novo.snapshot.tamanho;
+    if (ok) {
+        int s = 0;
+        novo.itens = (Componente*) (dados + deslocamento[s++]);
+        for (int k = 0; k < NUM_CRITERIOS; k++) novo.ordem[k] = (int*) (dados + deslocamento[s++]);
+        novo.tabelaNomes = (int*) (dados + deslocamento[s++]);
+        ColunasInventario *col = &novo.colunas;
+        col->prioridades = (uint8_t*) (dados + deslocamento[s++]);
+        col->tipos = (uint8_t*) (dados + deslocamento[s++]);
+        col->inicioNome = (uint32_t*) (dados + deslocamento[s++]);
+        col->nomes = dados + deslocamento[s++];
+        memcpy(col->nomesTipos, dados + deslocamento[s], tamanho[s]);
+        novo.total = novo.capacidade = (int) c.total;
+        novo.capacidadeTabela = (int) c.capacidadeTabela;
+        col->tamanhoNomes = col->capacidadeNomes = (size_t) c.tamanhoNomes;
+        col->numTipos = c.numTipos;
+        ok = snapshotCoerente(&novo);
+    }
+    for (int i = 0; ok && i < novo.total; i++) {
+        int prioridade = novo.itens[i].prioridade;
+        novo.contagemPrioridade[prioridade - PRIORIDADE_MINIMA]++;
+        ok = enfileirarMontagem(&novo.montagem, prioridade, i);
+    }
+    if (!ok) {
+        liberarInventario(&novo);
+        return 0;
+    }
+    liberarInventario(inv);
+    *inv = novo;
+    return 1;
+}
+
+/**
+ * @brief Tempo de exportar e importar CSV e de salvar e carregar o snapshot
+ * com 'total' componentes gerados, conferindo que os dois caminhos devolvem o
+ * mesmo inventário (componentes e índices).
+ */
+void benchmarkArquivos(int total) {
+    const char *csv = "bench_inventario.csv", *snapshot = "bench_inventario.snap";
+    Inventario original, copia;
+    if (total <= 0 || !inicializarInventario(&original) || !gerarComponentes(&original, total, 1)) {
+        printf("Erro: memoria insuficiente.\n");
+        return;
+    }
+    printf("%d componentes\n", total);
+    for (int etapa = 0; etapa < 4; etapa++) {
+        static const char *nomes[] = {"exportar CSV", "importar CSV", "salvar snapshot", "carregar snapshot"};
+        int ok = 1;
+        if (etapa == 1 || etapa == 3) ok = inicializarInventario(&copia);
+        long long inicio = agoraNs();
+        if (etapa == 0) ok = exportarCSV(&original, csv);
+        else if (etapa == 1) {
+            int rejeitadas;
+            ok = ok && importarCSV(&copia, csv, &rejeitadas) == total && rejeitadas == 0;
+        } else if (etapa == 2) ok = salvarSnapshot(&original, snapshot);
+        else ok = ok && carregarSnapshot(&copia, snapshot);
+        double ms = (agoraNs() - inicio) / 1e6;
+        const char *arquivo = etapa < 2 ? csv : snapshot;
+        FILE *f = fopen(arquivo, "rb");
+        long tamanho = 0;
+        if (f != NULL) {
+            fseek(f, 0, SEEK_END);
+            tamanho = ftell(f);
+            fclose(f);
+        }
+        printf("%-18s %10.1f ms  %8.1f MB%s\n", nomes[etapa], ms, tamanho / 1e6, ok ? "" : "  ERRO");
+        if (etapa == 1 || etapa == 3) {
+            int igual = ok;
+            for (int i = 0; igual && i < total; i++) {
+                igual = strcmp(original.itens[i].nome, copia.itens[i].nome) == 0 &&
+                        strcmp(original.itens[i].tipo, copia.itens[i].tipo) == 0 &&
+                        original.itens[i].prioridade == copia.itens[i].prioridade;
+            }
+            for (int k = 0; igual && k < NUM_CRITERIOS; k++) {
+                igual = memcmp(original.ordem[k], copia.ordem[k], (size_t) total * sizeof(int)) == 0;
+            }
+            if (!igual) printf("ERRO: inventario diferente do original\n");
+            liberarInventario(&copia);
+        }
+    }
+    remove(csv);
+    remove(snapshot);
+    liberarInventario(&original);
+}
@@ -0,0 +1,208 @@
+#ifndef TELA_H
+#define TELA_H
+
+/**
+ * @file Tela.h
+ * @brief Saída de tela compartilhada pelos jogos (Tetris, Free Fire e DetetiveQuest).
+ *
+ * Em vez de um printf por linha, cada quadro é montado num buffer reaproveitado
+ * e enviado com uma única chamada a write. No modo TELA_REDESENHO (terminal) o
+ * quadro é comparado linha a linha com o anterior e só as linhas que mudaram são
+ * reescritas, com sequências ANSI de posicionamento do cursor; no modo TELA_FLUXO
+ * (saída redirecionada para arquivo ou pipe) o texto sai inteiro e em ordem.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <io.h>
+#define TELA_WRITE(fd, buf, n) _write((fd), (buf), (unsigned int) (n))
+#define TELA_ISATTY _isatty
+#else
+#include <unistd.h>
+#define TELA_WRITE(fd, buf, n) write((fd), (buf), (n))
+#define TELA_ISATTY isatty
+#endif
+
+#if defined(__GNUC__)
+#define TELA_FORMATO_PRINTF __attribute__((format(printf, 2, 3)))
+#else
+#define TELA_FORMATO_PRINTF
+#endif
+
+// Modos de saída.
+#define TELA_FLUXO       0 // texto corrido: cada quadro é acrescentado ao que já saiu
+#define TELA_REDESENHO   1 // tela cheia: reescreve só as linhas que mudaram
+#define TELA_AUTOMATICO  2 // TELA_REDESENHO se o descritor for um terminal
+
+/**
+ * @brief Estado da saída: o quadro em montagem, o último mostrado e contadores.
+ */
+typedef struct {
+    char *quadro;            // quadro em montagem
+    size_t tamanho;
+    size_t capacidade;
+    size_t enviado;          // TELA_FLUXO: bytes do quadro que já foram escritos
+    char *anterior;          // TELA_REDESENHO: último quadro mostrado
+    size_t tamanho_anterior;
+    size_t capacidade_anterior;
+    char *saida;             // TELA_REDESENHO: bytes que vão para o write
+    size_t capacidade_saida;
+    int descritor;
+    int modo;
+    int primeiro;            // o próximo quadro limpa a tela antes
+    long long escritas;      // chamadas a write
+    long long bytes;         // bytes escritos
+    long long quadros;       // chamadas a telaMostrar
+} Tela;
+
+/**
+ * @brief Garante espaço para 'necessario' bytes, dobrando o buffer quando falta.
+ * Depois dos primeiros quadros o tamanho estabiliza e não há mais alocações.
+ * @return 1 se deu certo, 0 se faltou memória.
+ */
+static inline int telaReservar(char **buffer, size_t *capacidade, size_t necessario) {
+    if (necessario <= *capacidade) return 1;
+    size_t nova = *capacidade ? *capacidade : 4096;
+    while (nova < necessario) nova *= 2;
+    char *maior = (char*) realloc(*buffer, nova);
+    if (!maior) return 0;
+    *buffer = maior;
+    *capacidade = nova;
+    return 1;
+}
+
+/**
+ * @brief Prepara a tela para escrever no descritor dado (1 = saída padrão).
+ * @param modo TELA_FLUXO, TELA_REDESENHO ou TELA_AUTOMATICO.
+ */
+static inline void telaInicializar(Tela *t, int descritor, int modo) {
+    memset(t, 0, sizeof(*t));
+    t->descritor = descritor;
+    if (modo == TELA_AUTOMATICO) modo = TELA_ISATTY(descritor) ? TELA_REDESENHO : TELA_FLUXO;
+    t->modo = modo;
+    t->primeiro = 1;
+}
+
+static inline void telaLiberar(Tela *t) {
+    free(t->quadro);
+    free(t->anterior);
+    free(t->saida);
+    t->quadro = t->anterior = t->saida = NULL;
+    t->capacidade = t->capacidade_anterior = t->capacidade_saida = 0;
+}
+
+/**
+ * @brief Começa um quadro novo (o anterior continua guardado para a comparação).
+ */
+static inline void telaLimpar(Tela *t) {
+    t->tamanho = 0;
+    t->enviado = 0;
+}
+
+/**
+ * @brief Acrescenta texto formatado ao quadro, como printf.
+ */
+static inline void telaEscrever(Tela *t, const char *formato, ...) TELA_FORMATO_PRINTF;
+static inline void telaEscrever(Tela *t, const char *formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(t->quadro ? t->quadro + t->tamanho : NULL, t->capacidade - t->tamanho, formato, args);
+    va_end(args);
+    if (n < 0) return;
+    if (t->tamanho + (size_t) n >= t->capacidade) {
+        if (!telaReservar(&t->quadro, &t->capacidade, t->tamanho + (size_t) n + 1)) return;
+        va_start(args, formato);
+        vsnprintf(t->quadro + t->tamanho, t->capacidade - t->tamanho, formato, args);
+        va_end(args);
+    }
+    t->tamanho += (size_t) n;
+}
+
+static inline void telaEscreverBytes(Tela *t, const char *texto, size_t n) {
+    if (n == 0) return; // 'texto' pode ser NULL (um buffer vazio), e memcpy não aceita
+    if (!telaReservar(&t->quadro, &t->capacidade, t->tamanho + n + 1)) return;
+    memcpy(t->quadro + t->tamanho, texto, n);
+    t->tamanho += n;
+}
+
+static inline void telaAnexarSaida(Tela *t, size_t *usados, const char *texto, size_t n) {
+    if (n == 0) return;
+    if (!telaReservar(&t->saida, &t->capacidade_saida, *usados + n)) return;
+    memcpy(t->saida + *usados, texto, n);
+    *usados += n;
+}
+
+// Posiciona o cursor na linha 'linha' (começando em 0), coluna 'coluna'.
+static inline void telaAnexarCursor(Tela *t, size_t *usados, int linha, int coluna) {
+    char seq[32];
+    int n = snprintf(seq, sizeof(seq), "\x1b[%d;%dH", linha + 1, coluna + 1);
+    telaAnexarSaida(t, usados, seq, (size_t) n);
+}
+
+// Escreve tudo com write, repetindo se o sistema aceitar só parte dos bytes.
+static inline void telaEnviar(Tela *t, const char *dados, size_t n) {
+    while (n > 0) {
+        long escritos = (long) TELA_WRITE(t->descritor, dados, n);
+        t->escritas++;
+        if (escritos <= 0) return;
+        t->bytes += escritos;
+        dados += escritos;
+        n -= (size_t) escritos;
+    }
+}
+
+/**
+ * @brief Mostra o quadro com uma única chamada a write.
+ * Pode ser chamada de novo depois de acrescentar mais texto ao mesmo quadro
+ * (por exemplo, uma pergunta extra): só a diferença é enviada.
+ */
+static inline void telaMostrar(Tela *t) {
+    fflush(stdout); // o que ainda estiver no buffer do printf sai antes
+    t->quadros++;
+    if (t->modo == TELA_FLUXO) {
+        telaEnviar(t, t->quadro + t->enviado, t->tamanho - t->enviado);
+        t->enviado = t->tamanho;
+        return;
+    }
+
+    size_t usados = 0;
+    if (t->primeiro) {
+        telaAnexarSaida(t, &usados, "\x1b[H\x1b[2J", 7);
+        t->tamanho_anterior = 0;
+        t->primeiro = 0;
+    }
+    // Compara linha a linha. A última linha (normalmente a pergunta ao jogador)
+    // é sempre reescrita e seguida de "limpar até o fim da tela", o que apaga o
+    // eco da resposta anterior e deixa o cursor logo depois da pergunta.
+    const char *novo = t->quadro, *fim_novo = t->quadro + t->tamanho;
+    const char *velho = t->anterior, *fim_velho = t->anterior + t->tamanho_anterior;
+    int linha = 0;
+    for (;;) {
+        const char *quebra = (const char*) memchr(novo, '\n', (size_t) (fim_novo - novo));
+        if (!quebra) break;
+        size_t tam = (size_t) (quebra - novo);
+        const char *quebra_velha = velho ? (const char*) memchr(velho, '\n', (size_t) (fim_velho - velho)) : NULL;
+        if (!quebra_velha || (size_t) (quebra_velha - velho) != tam || memcmp(novo, velho, tam) != 0) {
+            telaAnexarCursor(t, &usados, linha, 0);
+            telaAnexarSaida(t, &usados, novo, tam);
+            telaAnexarSaida(t, &usados, "\x1b[K", 3);
+        }
+        velho = quebra_velha ? quebra_velha + 1 : NULL;
+        novo = quebra + 1;
+        linha++;
+    }
+    telaAnexarCursor(t, &usados, linha, 0);
+    telaAnexarSaida(t, &usados, novo, (size_t) (fim_novo - novo));
+    telaAnexarSaida(t, &usados, "\x1b[J", 3);
+    telaEnviar(t, t->saida, usados);
+
+    if (telaReservar(&t->anterior, &t->capacidade_anterior, t->tamanho)) {
+        memcpy(t->anterior, t->quadro, t->tamanho);
+        t->tamanho_anterior = t->tamanho;
+    }
+}
+
+#endif // TELA_H
@@ -1,192 +1,1796 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <time.h>
-
-// Define o tamanho mximo da nossa fila de peas
-#define TAMANHO_FILA 5
-
-// --- Estruturas de Dados ---
-
-/**
- * @brief Define a estrutura de uma pea do jogo.
- * Cada pea tem um nome (seu formato) e um ID nico.
- */
-typedef struct {
-    char nome;
-    int id;
-} Peca;
-
-/**
- * @brief Define a estrutura da fila circular.
- * Guarda as peas, os ndices de controle e a quantidade de itens.
- */
-typedef struct {
-    Peca itens[TAMANHO_FILA];
-    int inicio;     // ndice do primeiro elemento da fila.
-    int fim;        // ndice da prxima posio livre.
-    int quantidade; // Nmero de peas atualmente na fila.
-} Fila;
-
-
-// --- Funes Auxiliares e de Gerao ---
-
-/**
- * @brief Gera uma nova pea de Tetris de forma aleatria.
- * As peas so criadas com um ID sequencial para rastreamento.
- * @return A nova pea criada.
- */
-Peca gerarPeca() {
-    // Contador esttico para garantir que cada pea tenha um ID nico.
-    static int id_contador = 0;
-    Peca nova_peca;
-    char tipos_de_peca[] = {'I', 'O', 'T', 'L'};
-
-    // Escolhe um tipo de pea aleatoriamente
-    nova_peca.nome = tipos_de_peca[rand() % 4];
-    nova_peca.id = id_contador++;
-
-    return nova_peca;
-}
-
-
-// --- Funes de Manipulao da Fila ---
-
-/**
- * @brief Inicializa a fila, definindo seus valores padro.
- * Prepara a fila para ser usada.
- * @param f Ponteiro para a fila a ser inicializada.
- */
-void inicializarFila(Fila *f) {
-    f->inicio = 0;
-    f->fim = 0;
-    f->quantidade = 0;
-}
-
-/**
- * @brief Adiciona uma nova pea ao final da fila (enqueue).
- * @param f Ponteiro para a fila.
- * @param p A pea a ser inserida.
- * @return 1 se a operao foi bem-sucedida, 0 se a fila estava cheia.
- */
-int enfileirar(Fila *f, Peca p) {
-    // Verifica se a fila no est cheia antes de inserir.
-    if (f->quantidade >= TAMANHO_FILA) {
-        printf("\nAVISO: A fila de pecas esta cheia! Nao e possivel inserir.\n");
-        return 0; // Retorna 0 para indicar falha (fila cheia)
-    }
-
-    f->itens[f->fim] = p;
-    // Usa o operador de mdulo para garantir que o ndice 'fim' circule
-    // de volta ao incio do array quando atingir o final.
-    f->fim = (f->fim + 1) % TAMANHO_FILA;
-    f->quantidade++;
-
-    return 1; // Retorna 1 para indicar sucesso
-}
-
-/**
- * @brief Remove a pea da frente da fila (dequeue).
- * @param f Ponteiro para a fila.
- * @param p_removida Ponteiro para guardar a pea que foi removida.
- * @return 1 se a operao foi bem-sucedida, 0 se a fila estava vazia.
- */
-int desenfileirar(Fila *f, Peca *p_removida) {
-    // Verifica se a fila no est vazia antes de remover.
-    if (f->quantidade == 0) {
-        printf("\nAVISO: A fila de pecas esta vazia! Nao ha pecas para jogar.\n");
-        return 0; // Retorna 0 para indicar falha (fila vazia)
-    }
-
-    *p_removida = f->itens[f->inicio];
-    // Move o incio para a prxima posio, circulando se necessrio.
-    f->inicio = (f->inicio + 1) % TAMANHO_FILA;
-    f->quantidade--;
-
-    return 1; // Retorna 1 para indicar sucesso
-}
-
-
-// --- Funes de Interface com o Usurio ---
-
-/**
- * @brief Exibe o estado atual da fila de peas na tela.
- * A exibio percorre a fila de forma circular, do incio at o fim.
- * @param f Ponteiro para a fila a ser exibida.
- */
-void exibirFila(Fila *f) {
-    printf("\nFila de pecas: ");
-    if (f->quantidade == 0) {
-        printf("[VAZIA]");
-    } else {
-        int i;
-        int indice_atual;
-        for (i = 0; i < f->quantidade; i++) {
-            // Calcula o ndice real no array circular
-            indice_atual = (f->inicio + i) % TAMANHO_FILA;
-            printf("[%c %d] ", f->itens[indice_atual].nome, f->itens[indice_atual].id);
-        }
-    }
-    printf("\n");
-}
-
-/**
- * @brief Exibe o menu de opes para o jogador.
- */
-void exibirMenu() {
-    printf("\nOpcoes de acao:\n");
-    printf("1 - Jogar peca (dequeue)\n");
-    printf("2 - Inserir nova peca (enqueue)\n");
-    printf("0 - Sair\n");
-    printf("Escolha sua acao: ");
-}
-
-
-// --- Funo Principal ---
-
-int main() {
-    // Prepara o gerador de nmeros aleatrios
-    srand(time(NULL));
-
-    Fila fila_de_pecas;
-    int opcao;
-
-    // Inicia a fila e j a preenche com o nmero mximo de peas.
-    inicializarFila(&fila_de_pecas);
-    for (int i = 0; i < TAMANHO_FILA; i++) {
-        enfileirar(&fila_de_pecas, gerarPeca());
-    }
-
-    // Loop principal do jogo
-    do {
-        exibirFila(&fila_de_pecas);
-        exibirMenu();
-        scanf("%d", &opcao);
-
-        switch (opcao) {
-            case 1: { // Jogar pea (dequeue)
-                Peca peca_jogada;
-                if (desenfileirar(&fila_de_pecas, &peca_jogada)) {
-                    printf("\n=> Peca jogada: [%c %d]\n", peca_jogada.nome, peca_jogada.id);
-                }
-                break;
-            }
-            case 2: { // Inserir nova pea (enqueue)
-                Peca nova_peca = gerarPeca();
-                if (enfileirar(&fila_de_pecas, nova_peca)) {
-                     printf("\n=> Nova peca inserida: [%c %d]\n", nova_peca.nome, nova_peca.id);
-                }
-                break;
-            }
-            case 0: { // Sair
-                printf("\nFim de jogo. Ate a proxima!\n");
-                break;
-            }
-            default: {
-                printf("\nOpcao invalida. Tente novamente.\n");
-            }
-        }
-
-    } while (opcao != 0);
-
-    return 0;
-}
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include "Tela.h"
+
+// Define o tamanho máximo da nossa fila de peças
+#define TAMANHO_FILA 5
+
+// Os sete tetraminós, na ordem usada pelo gerador.
+#define NUM_TIPOS_PECA 7
+static const char TIPOS_DE_PECA[NUM_TIPOS_PECA] = {'I', 'O', 'T', 'S', 'Z', 'J', 'L'};
+
+// Modos do gerador de peças.
+#define GERADOR_ALEATORIO 0 // cada peça sorteada de forma independente
+#define GERADOR_SACO      1 // "7-bag": as sete peças embaralhadas, uma rodada por vez
+
+// Dimensões do tabuleiro. Cada linha é uma máscara de bits (bit x = coluna x);
+// o vetor tem LINHAS_ALOCADAS posições para a varredura SIMD ler blocos
+// inteiros, e as linhas acima de ALTURA_TABULEIRO ficam sempre vazias.
+#define LARGURA_TABULEIRO 10
+#define ALTURA_TABULEIRO  20
+#define LINHAS_ALOCADAS   32
+#define LINHA_CHEIA       ((uint16_t) ((1u << LARGURA_TABULEIRO) - 1))
+
+// Resultados de passoTabuleiro além do número de linhas eliminadas.
+#define JOGADA_INVALIDA -2 // rotação ou coluna fora do tabuleiro
+#define FIM_DE_JOGO     -1 // a peça não cabe mais
+
+// IA: quantas peças da fila ela olha além da atual, e os pesos da heurística
+// (altura somada, linhas, buracos e irregularidade entre colunas vizinhas).
+#define PREVIA_PADRAO        2
+#define PREVIA_MAXIMA        (TAMANHO_FILA - 1)
+#define MAX_JOGADAS          (4 * LARGURA_TABULEIRO)
+#define PESO_ALTURA          -0.510066
+#define PESO_LINHAS           0.760666
+#define PESO_BURACOS         -0.356630
+#define PESO_IRREGULARIDADE  -0.184483
+#define VALOR_PERDIDO        -1e9 // nenhuma jogada cabe
+
+// Replay: cada entrada do jogador ocupa um byte, com a ação nos 2 bits altos e,
+// para REPLAY_JOGAR, a rotação (2 bits) e a coluna (4 bits) nos baixos.
+#define REPLAY_JOGAR       0 // tira a peça da frente e a solta na rotação/coluna
+#define REPLAY_INSERIR     1 // gera uma peça e tenta pô-la na fila
+#define REPLAY_DESCARTAR   2 // tira a peça da frente sem jogá-la
+#define REPLAY_VERSAO      1
+#define REPLAY_CABECALHO   20 // "TTRP", versão, modo, 2 reservados, semente, quantidade
+
+// --- Estruturas de Dados ---
+
+/**
+ * @brief Define a estrutura de uma peça do jogo.
+ * Cada peça tem um nome (seu formato) e um ID único.
+ */
+typedef struct {
+    char nome;
+    int id;
+} Peca;
+
+/**
+ * @brief Define a estrutura da fila circular.
+ * Guarda as peças, os índices de controle e a quantidade de itens.
+ */
+typedef struct {
+    Peca itens[TAMANHO_FILA];
+    int inicio;     // Índice do primeiro elemento da fila.
+    int fim;        // Índice da próxima posição livre.
+    int quantidade; // Número de peças atualmente na fila.
+} Fila;
+
+/**
+ * @brief Gerador de peças com estado próprio (xoshiro256**).
+ * Cada instância é independente: a mesma semente e o mesmo modo produzem sempre
+ * a mesma sequência de peças, e threads diferentes não disputam estado global.
+ */
+typedef struct {
+    uint64_t estado[4];
+    int modo;                    // GERADOR_ALEATORIO ou GERADOR_SACO
+    char saco[NUM_TIPOS_PECA];   // peças ainda não sorteadas da rodada atual
+    int restantes_no_saco;
+    int id_contador;             // ID da próxima peça
+} Gerador;
+
+/**
+ * @brief Uma rotação de uma peça, como máscaras de linha encostadas à esquerda.
+ * linhas[0] é a linha de baixo da peça.
+ */
+typedef struct {
+    uint16_t linhas[4];
+    int largura;
+    int altura;
+} Forma;
+
+/**
+ * @brief Tabuleiro do jogo: uma máscara de bits por linha, de baixo para cima.
+ */
+typedef struct {
+    alignas(16) uint16_t linhas[LINHAS_ALOCADAS];
+    int altura;                 // linhas ocupadas: acima disso tudo está vazio
+    int fim_de_jogo;
+    long long pecas_colocadas;
+    long long linhas_eliminadas;
+} Tabuleiro;
+
+/**
+ * @brief Estado completo de uma partida: tudo o que as entradas do jogador
+ * alteram. A partir da mesma semente e das mesmas entradas chega-se sempre ao
+ * mesmo estado.
+ */
+typedef struct {
+    Gerador gerador;
+    Fila fila;
+    Tabuleiro tabuleiro;
+    int partidas;              // partidas iniciadas (recomeça a cada fim de jogo)
+    long long pecas_anteriores;  // peças das partidas já encerradas
+    long long linhas_anteriores; // linhas das partidas já encerradas
+} Sessao;
+
+/**
+ * @brief Gravação de uma sessão: semente, modo do gerador e as entradas.
+ */
+typedef struct {
+    uint64_t semente;
+    int modo;
+    uint8_t *entradas;
+    size_t quantidade;
+    size_t capacidade;
+} Replay;
+
+/**
+ * @brief Resumo do estado final, para comparar uma reprodução com o original.
+ */
+typedef struct {
+    int partidas;
+    long long pecas;
+    long long linhas;
+    uint64_t assinatura; // hash do tabuleiro, da fila e do gerador
+} ResumoSessao;
+
+/**
+ * @brief Uma jogada: rotação e coluna onde soltar a peça.
+ */
+typedef struct {
+    int rotacao;
+    int coluna;
+} Jogada;
+
+/**
+ * @brief Posição da tabela de transposição, gravada sem travas: guarda o valor
+ * e a chave XOR o valor. Se duas threads escreverem ao mesmo tempo, o par fica
+ * inconsistente e a leitura simplesmente não reconhece a chave.
+ */
+typedef struct {
+    std::atomic<uint64_t> chave_xor_valor;
+    std::atomic<uint64_t> valor;
+} EntradaTransposicao;
+
+/**
+ * @brief Memoriza o valor de tabuleiros já avaliados, compartilhada pelas threads.
+ */
+typedef struct {
+    EntradaTransposicao *entradas;
+    size_t mascara; // capacidade - 1 (capacidade é potência de 2)
+} TabelaTransposicao;
+
+// Tamanho de uma linha de cache; índices escritos por threads diferentes ficam
+// em linhas separadas para que uma thread não invalide a linha da outra.
+#define TAMANHO_LINHA_CACHE 64
+
+/**
+ * @brief Fila circular sem travas para um produtor e um consumidor (SPSC).
+ * Os índices só crescem; a posição no vetor é índice & mascara. Cada lado guarda
+ * uma cópia do índice do outro e só relê o atômico quando a cópia diz cheio/vazio.
+ */
+typedef struct {
+    alignas(TAMANHO_LINHA_CACHE) std::atomic<size_t> fim; // escrito só pelo produtor
+    size_t inicio_visto;                                  // cópia do produtor
+    alignas(TAMANHO_LINHA_CACHE) std::atomic<size_t> inicio; // escrito só pelo consumidor
+    size_t fim_visto;                                        // cópia do consumidor
+    alignas(TAMANHO_LINHA_CACHE) Peca *itens;
+    size_t mascara; // capacidade - 1 (capacidade é potência de 2)
+} FilaSPSC;
+
+/**
+ * @brief Posição da fila MPMC: a sequência diz de quem é a vez de usar a posição.
+ */
+typedef struct {
+    std::atomic<size_t> sequencia;
+    Peca peca;
+} CelulaFila;
+
+/**
+ * @brief Fila circular sem travas para vários produtores e consumidores (MPMC),
+ * no esquema de D. Vyukov: cada lado reserva uma posição com compare-and-swap no
+ * seu índice e a sequência da célula publica a peça para o outro lado.
+ */
+typedef struct {
+    alignas(TAMANHO_LINHA_CACHE) std::atomic<size_t> fim;
+    alignas(TAMANHO_LINHA_CACHE) std::atomic<size_t> inicio;
+    alignas(TAMANHO_LINHA_CACHE) CelulaFila *celulas;
+    size_t mascara;
+} FilaMPMC;
+
+
+// --- Funções Auxiliares e de Geração ---
+
+static inline uint64_t rotacionar(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief Próximo número de 64 bits do xoshiro256** (Blackman e Vigna).
+ */
+static inline uint64_t proximoAleatorio(Gerador *g) {
+    uint64_t *s = g->estado;
+    uint64_t resultado = rotacionar(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotacionar(s[3], 45);
+    return resultado;
+}
+
+/**
+ * @brief Sorteia um número em [0, n) sem o viés de "% n" (método de D. Lemire:
+ * multiplica e só repete o sorteio nos raros valores que sobrariam).
+ */
+static inline uint32_t sortearAte(Gerador *g, uint32_t n) {
+    uint64_t m = (uint64_t) (uint32_t) (proximoAleatorio(g) >> 32) * n;
+    uint32_t resto = (uint32_t) m;
+    if (resto < n) {
+        uint32_t limite = (0u - n) % n;
+        while (resto < limite) {
+            m = (uint64_t) (uint32_t) (proximoAleatorio(g) >> 32) * n;
+            resto = (uint32_t) m;
+        }
+    }
+    return (uint32_t) (m >> 32);
+}
+
+/**
+ * @brief Prepara o gerador a partir de uma semente.
+ * O estado de 256 bits é preenchido com splitmix64, que espalha bem até sementes
+ * pequenas como 0, 1, 2...
+ * @param g Ponteiro para o gerador.
+ * @param semente Semente; a mesma semente repete a mesma sequência de peças.
+ * @param modo GERADOR_ALEATORIO ou GERADOR_SACO.
+ */
+void semearGerador(Gerador *g, uint64_t semente, int modo) {
+    for (int i = 0; i < 4; i++) {
+        semente += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = semente;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        g->estado[i] = z ^ (z >> 31);
+    }
+    g->modo = modo;
+    g->restantes_no_saco = 0;
+    g->id_contador = 0;
+}
+
+/**
+ * @brief Gera uma nova peça de Tetris.
+ * No modo GERADOR_SACO as sete peças são embaralhadas (Fisher-Yates) e entregues
+ * uma a uma, de modo que cada rodada de sete tem todas elas; no modo
+ * GERADOR_ALEATORIO cada peça é sorteada de forma independente.
+ * As peças são criadas com um ID sequencial para rastreamento.
+ * @param g Ponteiro para o gerador.
+ * @return A nova peça criada.
+ */
+Peca gerarPeca(Gerador *g) {
+    Peca nova_peca;
+
+    if (g->modo == GERADOR_SACO) {
+        if (g->restantes_no_saco == 0) {
+            memcpy(g->saco, TIPOS_DE_PECA, NUM_TIPOS_PECA);
+            for (int i = NUM_TIPOS_PECA - 1; i > 0; i--) {
+                int j = (int) sortearAte(g, i + 1);
+                char troca = g->saco[i];
+                g->saco[i] = g->saco[j];
+                g->saco[j] = troca;
+            }
+            g->restantes_no_saco = NUM_TIPOS_PECA;
+        }
+        nova_peca.nome = g->saco[--g->restantes_no_saco];
+    } else {
+        nova_peca.nome = TIPOS_DE_PECA[sortearAte(g, NUM_TIPOS_PECA)];
+    }
+    nova_peca.id = g->id_contador++;
+
+    return nova_peca;
+}
+
+
+// --- Funções de Manipulação da Fila ---
+
+/**
+ * @brief Inicializa a fila, definindo seus valores padrão.
+ * Prepara a fila para ser usada.
+ * @param f Ponteiro para a fila a ser inicializada.
+ */
+void inicializarFila(Fila *f) {
+    f->inicio = 0;
+    f->fim = 0;
+    f->quantidade = 0;
+}
+
+/**
+ * @brief Adiciona uma nova peça ao final da fila (enqueue).
+ * Não escreve nada na tela: quem chama decide como avisar o jogador.
+ * @param f Ponteiro para a fila.
+ * @param p A peça a ser inserida.
+ * @return 1 se a operação foi bem-sucedida, 0 se a fila estava cheia.
+ */
+int enfileirar(Fila *f, Peca p) {
+    // Verifica se a fila não está cheia antes de inserir.
+    if (f->quantidade >= TAMANHO_FILA) {
+        return 0; // Retorna 0 para indicar falha (fila cheia)
+    }
+
+    f->itens[f->fim] = p;
+    // Usa o operador de módulo para garantir que o índice 'fim' circule
+    // de volta ao início do array quando atingir o final.
+    f->fim = (f->fim + 1) % TAMANHO_FILA;
+    f->quantidade++;
+
+    return 1; // Retorna 1 para indicar sucesso
+}
+
+/**
+ * @brief Remove a peça da frente da fila (dequeue).
+ * Não escreve nada na tela: quem chama decide como avisar o jogador.
+ * @param f Ponteiro para a fila.
+ * @param p_removida Ponteiro para guardar a peça que foi removida.
+ * @return 1 se a operação foi bem-sucedida, 0 se a fila estava vazia.
+ */
+int desenfileirar(Fila *f, Peca *p_removida) {
+    // Verifica se a fila não está vazia antes de remover.
+    if (f->quantidade == 0) {
+        return 0; // Retorna 0 para indicar falha (fila vazia)
+    }
+
+    *p_removida = f->itens[f->inicio];
+    // Move o início para a próxima posição, circulando se necessário.
+    f->inicio = (f->inicio + 1) % TAMANHO_FILA;
+    f->quantidade--;
+
+    return 1; // Retorna 1 para indicar sucesso
+}
+
+/**
+ * @brief Adiciona até 'n' peças ao final da fila, na ordem do vetor.
+ * As peças vão em no máximo duas cópias: até o fim do vetor e, se a fila der a
+ * volta, do começo dele em diante.
+ * @param f Ponteiro para a fila.
+ * @param pecas Peças a inserir.
+ * @param n Quantidade de peças no vetor.
+ * @return Quantas peças couberam (0 se a fila estava cheia).
+ */
+int enfileirarLote(Fila *f, const Peca *pecas, int n) {
+    int livres = TAMANHO_FILA - f->quantidade;
+    if (n > livres) n = livres;
+    if (n <= 0) return 0;
+
+    int ate_o_fim = TAMANHO_FILA - f->fim;
+    int primeira_parte = n < ate_o_fim ? n : ate_o_fim;
+    memcpy(&f->itens[f->fim], pecas, primeira_parte * sizeof(Peca));
+    memcpy(f->itens, pecas + primeira_parte, (n - primeira_parte) * sizeof(Peca));
+    f->fim += n;
+    if (f->fim >= TAMANHO_FILA) f->fim -= TAMANHO_FILA;
+    f->quantidade += n;
+    return n;
+}
+
+/**
+ * @brief Remove até 'n' peças da frente da fila, em ordem, para 'destino'.
+ * Como em enfileirarLote, são no máximo duas cópias.
+ * @param f Ponteiro para a fila.
+ * @param destino Vetor com espaço para 'n' peças.
+ * @param n Máximo de peças a remover.
+ * @return Quantas peças foram removidas (0 se a fila estava vazia).
+ */
+int desenfileirarLote(Fila *f, Peca *destino, int n) {
+    if (n > f->quantidade) n = f->quantidade;
+    if (n <= 0) return 0;
+
+    int ate_o_fim = TAMANHO_FILA - f->inicio;
+    int primeira_parte = n < ate_o_fim ? n : ate_o_fim;
+    memcpy(destino, &f->itens[f->inicio], primeira_parte * sizeof(Peca));
+    memcpy(destino + primeira_parte, f->itens, (n - primeira_parte) * sizeof(Peca));
+    f->inicio += n;
+    if (f->inicio >= TAMANHO_FILA) f->inicio -= TAMANHO_FILA;
+    f->quantidade -= n;
+    return n;
+}
+
+/**
+ * @brief Copia até 'n' peças da frente da fila sem removê-las (a prévia).
+ * @return Quantas peças foram copiadas.
+ */
+int espiarFila(const Fila *f, Peca *destino, int n) {
+    if (n > f->quantidade) n = f->quantidade;
+    if (n <= 0) return 0;
+
+    int ate_o_fim = TAMANHO_FILA - f->inicio;
+    int primeira_parte = n < ate_o_fim ? n : ate_o_fim;
+    memcpy(destino, &f->itens[f->inicio], primeira_parte * sizeof(Peca));
+    memcpy(destino + primeira_parte, f->itens, (n - primeira_parte) * sizeof(Peca));
+    return n;
+}
+
+
+// --- Filas Concorrentes (sem travas) ---
+
+/**
+ * @brief Menor potência de 2 maior ou igual a n (no mínimo 2).
+ */
+static size_t potenciaDe2(size_t n) {
+    size_t p = 2;
+    while (p < n) p *= 2;
+    return p;
+}
+
+/**
+ * @brief Prepara uma fila SPSC com pelo menos 'capacidade' posições.
+ * @return 1 se deu certo, 0 se faltou memória.
+ */
+int inicializarFilaSPSC(FilaSPSC *f, size_t capacidade) {
+    capacidade = potenciaDe2(capacidade);
+    f->itens = (Peca*) malloc(capacidade * sizeof(Peca));
+    if (f->itens == NULL) return 0;
+    f->mascara = capacidade - 1;
+    f->inicio.store(0, std::memory_order_relaxed);
+    f->fim.store(0, std::memory_order_relaxed);
+    f->inicio_visto = 0;
+    f->fim_visto = 0;
+    return 1;
+}
+
+void liberarFilaSPSC(FilaSPSC *f) {
+    free(f->itens);
+    f->itens = NULL;
+}
+
+/**
+ * @brief Insere uma peça (só o produtor chama).
+ * @return 1 se inseriu, 0 se a fila estava cheia.
+ */
+int enfileirarSPSC(FilaSPSC *f, Peca p) {
+    size_t fim = f->fim.load(std::memory_order_relaxed);
+    if (fim - f->inicio_visto > f->mascara) {
+        f->inicio_visto = f->inicio.load(std::memory_order_acquire);
+        if (fim - f->inicio_visto > f->mascara) return 0;
+    }
+    f->itens[fim & f->mascara] = p;
+    f->fim.store(fim + 1, std::memory_order_release);
+    return 1;
+}
+
+/**
+ * @brief Remove a peça da frente (só o consumidor chama).
+ * @return 1 se removeu, 0 se a fila estava vazia.
+ */
+int desenfileirarSPSC(FilaSPSC *f, Peca *p_removida) {
+    size_t inicio = f->inicio.load(std::memory_order_relaxed);
+    if (inicio == f->fim_visto) {
+        f->fim_visto = f->fim.load(std::memory_order_acquire);
+        if (inicio == f->fim_visto) return 0;
+    }
+    *p_removida = f->itens[inicio & f->mascara];
+    f->inicio.store(inicio + 1, std::memory_order_release);
+    return 1;
+}
+
+/**
+ * @brief Prepara uma fila MPMC com pelo menos 'capacidade' posições.
+ * @return 1 se deu certo, 0 se faltou memória.
+ */
+int inicializarFilaMPMC(FilaMPMC *f, size_t capacidade) {
+    capacidade = potenciaDe2(capacidade);
+    f->celulas = new (std::nothrow) CelulaFila[capacidade];
+    if (f->celulas == NULL) return 0;
+    for (size_t i = 0; i < capacidade; i++) f->celulas[i].sequencia.store(i, std::memory_order_relaxed);
+    f->mascara = capacidade - 1;
+    f->inicio.store(0, std::memory_order_relaxed);
+    f->fim.store(0, std::memory_order_relaxed);
+    return 1;
+}
+
+void liberarFilaMPMC(FilaMPMC *f) {
+    delete[] f->celulas;
+    f->celulas = NULL;
+}
+
+/**
+ * @brief Insere uma peça; pode ser chamada por vários produtores ao mesmo tempo.
+ * A célula está livre quando sua sequência é igual ao índice de fim.
+ * @return 1 se inseriu, 0 se a fila estava cheia.
+ */
+int enfileirarMPMC(FilaMPMC *f, Peca p) {
+    size_t fim = f->fim.load(std::memory_order_relaxed);
+    while (1) {
+        CelulaFila *c = &f->celulas[fim & f->mascara];
+        size_t seq = c->sequencia.load(std::memory_order_acquire);
+        long diferenca = (long) (seq - fim);
+        if (diferenca == 0) {
+            if (f->fim.compare_exchange_weak(fim, fim + 1, std::memory_order_relaxed)) {
+                c->peca = p;
+                c->sequencia.store(fim + 1, std::memory_order_release);
+                return 1;
+            }
+        } else if (diferenca < 0) {
+            return 0; // a célula ainda guarda uma peça de uma volta anterior
+        } else {
+            fim = f->fim.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Remove a peça da frente; pode ser chamada por vários consumidores.
+ * A célula tem peça quando sua sequência é o índice de início + 1.
+ * @return 1 se removeu, 0 se a fila estava vazia.
+ */
+int desenfileirarMPMC(FilaMPMC *f, Peca *p_removida) {
+    size_t inicio = f->inicio.load(std::memory_order_relaxed);
+    while (1) {
+        CelulaFila *c = &f->celulas[inicio & f->mascara];
+        size_t seq = c->sequencia.load(std::memory_order_acquire);
+        long diferenca = (long) (seq - (inicio + 1));
+        if (diferenca == 0) {
+            if (f->inicio.compare_exchange_weak(inicio, inicio + 1, std::memory_order_relaxed)) {
+                *p_removida = c->peca;
+                c->sequencia.store(inicio + f->mascara + 1, std::memory_order_release);
+                return 1;
+            }
+        } else if (diferenca < 0) {
+            return 0;
+        } else {
+            inicio = f->inicio.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// --- Tabuleiro (bitboard) ---
+
+// Células de cada peça na orientação inicial, como pares (x, y) com y para cima.
+static const int CELULAS_INICIAIS[NUM_TIPOS_PECA][4][2] = {
+    {{0, 0}, {1, 0}, {2, 0}, {3, 0}}, // I
+    {{0, 0}, {1, 0}, {0, 1}, {1, 1}}, // O
+    {{0, 0}, {1, 0}, {2, 0}, {1, 1}}, // T
+    {{0, 0}, {1, 0}, {1, 1}, {2, 1}}, // S
+    {{1, 0}, {2, 0}, {0, 1}, {1, 1}}, // Z
+    {{0, 1}, {0, 0}, {1, 0}, {2, 0}}, // J
+    {{2, 1}, {0, 0}, {1, 0}, {2, 0}}, // L
+};
+
+// Rotações distintas de cada peça (O tem 1; I, S e Z têm 2; as outras, 4).
+static Forma formas[NUM_TIPOS_PECA][4];
+static int num_rotacoes[NUM_TIPOS_PECA];
+
+/**
+ * @brief Monta a tabela de formas girando as células 90 graus por vez e
+ * descartando as rotações repetidas. Chamada uma vez no início do programa.
+ */
+void inicializarFormas() {
+    for (int tipo = 0; tipo < NUM_TIPOS_PECA; tipo++) {
+        int celulas[4][2];
+        memcpy(celulas, CELULAS_INICIAIS[tipo], sizeof(celulas));
+        num_rotacoes[tipo] = 0;
+        for (int r = 0; r < 4; r++) {
+            int min_x = celulas[0][0], min_y = celulas[0][1];
+            for (int c = 1; c < 4; c++) {
+                if (celulas[c][0] < min_x) min_x = celulas[c][0];
+                if (celulas[c][1] < min_y) min_y = celulas[c][1];
+            }
+            Forma f;
+            memset(&f, 0, sizeof(f));
+            for (int c = 0; c < 4; c++) {
+                int x = celulas[c][0] - min_x, y = celulas[c][1] - min_y;
+                f.linhas[y] |= (uint16_t) (1u << x);
+                if (x + 1 > f.largura) f.largura = x + 1;
+                if (y + 1 > f.altura) f.altura = y + 1;
+            }
+            int repetida = 0;
+            for (int k = 0; k < num_rotacoes[tipo]; k++) {
+                if (memcmp(&formas[tipo][k], &f, sizeof(f)) == 0) repetida = 1;
+            }
+            if (!repetida) formas[tipo][num_rotacoes[tipo]++] = f;
+            // Gira 90 graus no sentido horário: (x, y) -> (y, -x).
+            for (int c = 0; c < 4; c++) {
+                int x = celulas[c][0];
+                celulas[c][0] = celulas[c][1];
+                celulas[c][1] = -x;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Converte o nome de uma peça ('I', 'O', ...) no índice usado pelas tabelas.
+ * @return O índice, ou -1 se o nome não for de um tetraminó.
+ */
+int indiceDoTipo(char nome) {
+    for (int i = 0; i < NUM_TIPOS_PECA; i++) {
+        if (TIPOS_DE_PECA[i] == nome) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Esvazia o tabuleiro e zera as estatísticas.
+ */
+void inicializarTabuleiro(Tabuleiro *t) {
+    memset(t, 0, sizeof(*t));
+}
+
+/**
+ * @brief Diz se a forma, com o canto inferior esquerdo em (x, y), encosta em
+ * algum bloco. Cada linha da peça é deslocada até a coluna x e comparada com a
+ * linha do tabuleiro num único AND.
+ */
+static inline int colide(const Tabuleiro *t, const Forma *f, int x, int y) {
+    if (y < 0) return 1;
+    for (int r = 0; r < f->altura; r++) {
+        if ((uint16_t) (f->linhas[r] << x) & t->linhas[y + r]) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Máscara com um bit por linha cheia (bit y = linha y).
+ * Com SSE2 compara oito linhas por instrução e junta os resultados com
+ * _mm_packs_epi16, que reduz cada linha a um byte para o _mm_movemask_epi8.
+ */
+static inline uint32_t mascaraLinhasCheias(const Tabuleiro *t) {
+    uint32_t mascara = 0;
+#ifdef __SSE2__
+    const __m128i cheia = _mm_set1_epi16((short) LINHA_CHEIA);
+    for (int y = 0; y < LINHAS_ALOCADAS; y += 16) {
+        __m128i baixo = _mm_cmpeq_epi16(_mm_load_si128((const __m128i *) &t->linhas[y]), cheia);
+        __m128i cima = _mm_cmpeq_epi16(_mm_load_si128((const __m128i *) &t->linhas[y + 8]), cheia);
+        mascara |= (uint32_t) _mm_movemask_epi8(_mm_packs_epi16(baixo, cima)) << y;
+    }
+#else
+    for (int y = 0; y < t->altura; y++) {
+        if (t->linhas[y] == LINHA_CHEIA) mascara |= 1u << y;
+    }
+#endif
+    return mascara;
+}
+
+/**
+ * @brief Remove as linhas marcadas em 'cheias' e desce as de cima.
+ * @return Quantas linhas foram removidas.
+ */
+static int compactarLinhas(Tabuleiro *t, uint32_t cheias) {
+    int destino = 0;
+    while (!(cheias & (1u << destino))) destino++;
+    for (int y = destino; y < t->altura; y++) {
+        if (!(cheias & (1u << y))) t->linhas[destino++] = t->linhas[y];
+    }
+    int removidas = t->altura - destino;
+    for (int y = destino; y < t->altura; y++) t->linhas[y] = 0;
+    t->altura = destino;
+    return removidas;
+}
+
+/**
+ * @brief Joga uma peça: solta a forma na coluna indicada até encostar, grava
+ * os blocos e elimina as linhas completadas. É a API sem tela usada pelos bots.
+ * @param t Ponteiro para o tabuleiro.
+ * @param tipo Índice da peça (ver indiceDoTipo).
+ * @param rotacao Rotação, de 0 a num_rotacoes[tipo] - 1.
+ * @param coluna Coluna do bloco mais à esquerda da peça.
+ * @return Linhas eliminadas (0 a 4), JOGADA_INVALIDA ou FIM_DE_JOGO.
+ */
+int passoTabuleiro(Tabuleiro *t, int tipo, int rotacao, int coluna) {
+    if (t->fim_de_jogo) return FIM_DE_JOGO;
+    if (tipo < 0 || tipo >= NUM_TIPOS_PECA || rotacao < 0 || rotacao >= num_rotacoes[tipo]) {
+        return JOGADA_INVALIDA;
+    }
+    const Forma *f = &formas[tipo][rotacao];
+    if (coluna < 0 || coluna + f->largura > LARGURA_TABULEIRO) return JOGADA_INVALIDA;
+
+    // Acima de t->altura não há blocos: a peça desce livre até ali.
+    int y = t->altura;
+    if (y > ALTURA_TABULEIRO - f->altura) {
+        y = ALTURA_TABULEIRO - f->altura;
+        if (colide(t, f, coluna, y)) {
+            t->fim_de_jogo = 1;
+            return FIM_DE_JOGO;
+        }
+    }
+    while (!colide(t, f, coluna, y - 1)) y--;
+
+    for (int r = 0; r < f->altura; r++) t->linhas[y + r] |= (uint16_t) (f->linhas[r] << coluna);
+    if (y + f->altura > t->altura) t->altura = y + f->altura;
+    t->pecas_colocadas++;
+
+    uint32_t cheias = mascaraLinhasCheias(t);
+    if (cheias == 0) return 0;
+    int removidas = compactarLinhas(t, cheias);
+    t->linhas_eliminadas += removidas;
+    return removidas;
+}
+
+
+// --- Sessão e Replay ---
+
+/**
+ * @brief Começa uma sessão: semeia o gerador, esvazia o tabuleiro e enche a fila.
+ */
+void iniciarSessao(Sessao *s, uint64_t semente, int modo) {
+    semearGerador(&s->gerador, semente, modo);
+    inicializarTabuleiro(&s->tabuleiro);
+    s->partidas = 1;
+    s->pecas_anteriores = 0;
+    s->linhas_anteriores = 0;
+
+    // Inicia a fila e já a preenche com o número máximo de peças.
+    inicializarFila(&s->fila);
+    Peca iniciais[TAMANHO_FILA];
+    for (int i = 0; i < TAMANHO_FILA; i++) {
+        iniciais[i] = gerarPeca(&s->gerador);
+    }
+    enfileirarLote(&s->fila, iniciais, TAMANHO_FILA);
+}
+
+/**
+ * @brief Se a jogada encerrou a partida, guarda as estatísticas e recomeça o tabuleiro.
+ */
+void encerrarPartidaSeAcabou(Sessao *s, int resultado) {
+    if (resultado != FIM_DE_JOGO) return;
+    s->pecas_anteriores += s->tabuleiro.pecas_colocadas;
+    s->linhas_anteriores += s->tabuleiro.linhas_eliminadas;
+    s->partidas++;
+    inicializarTabuleiro(&s->tabuleiro);
+}
+
+void resumirSessao(const Sessao *s, ResumoSessao *resumo) {
+    resumo->partidas = s->partidas;
+    resumo->pecas = s->pecas_anteriores + s->tabuleiro.pecas_colocadas;
+    resumo->linhas = s->linhas_anteriores + s->tabuleiro.linhas_eliminadas;
+    // Só entram as peças que estão na fila: as outras posições do vetor e o
+    // preenchimento de Peca não são inicializados.
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (int y = 0; y < LINHAS_ALOCADAS; y++) h = (h ^ s->tabuleiro.linhas[y]) * 0x100000001B3ULL;
+    for (int i = 0; i < 4; i++) h = (h ^ s->gerador.estado[i]) * 0x100000001B3ULL;
+    for (int i = 0; i < s->fila.quantidade; i++) {
+        const Peca *p = &s->fila.itens[(s->fila.inicio + i) % TAMANHO_FILA];
+        h = (h ^ (uint64_t) p->nome) * 0x100000001B3ULL;
+        h = (h ^ (uint64_t) p->id) * 0x100000001B3ULL;
+    }
+    resumo->assinatura = h;
+}
+
+void inicializarReplay(Replay *r, uint64_t semente, int modo) {
+    r->semente = semente;
+    r->modo = modo;
+    r->entradas = NULL;
+    r->quantidade = 0;
+    r->capacidade = 0;
+}
+
+void liberarReplay(Replay *r) {
+    free(r->entradas);
+    r->entradas = NULL;
+    r->quantidade = r->capacidade = 0;
+}
+
+/**
+ * @brief Anota uma entrada no fim da gravação (o vetor dobra quando enche).
+ * @return 1 se deu certo, 0 se faltou memória.
+ */
+int gravarEntrada(Replay *r, int acao, int rotacao, int coluna) {
+    if (r->quantidade == r->capacidade) {
+        size_t nova = r->capacidade ? r->capacidade * 2 : 256;
+        uint8_t *entradas = (uint8_t *) realloc(r->entradas, nova);
+        if (!entradas) return 0;
+        r->entradas = entradas;
+        r->capacidade = nova;
+    }
+    r->entradas[r->quantidade++] = (uint8_t) (acao << 6 | (rotacao & 3) << 4 | (coluna & 15));
+    return 1;
+}
+
+/**
+ * @brief Grava o replay em disco: cabeçalho de REPLAY_CABECALHO bytes, com os
+ * números em little-endian, seguido de um byte por entrada.
+ * @return 1 se deu certo, 0 em erro de escrita.
+ */
+int salvarReplay(const Replay *r, const char *caminho) {
+    uint8_t cabecalho[REPLAY_CABECALHO] = {'T', 'T', 'R', 'P', REPLAY_VERSAO, (uint8_t) r->modo, 0, 0};
+    for (int i = 0; i < 8; i++) cabecalho[8 + i] = (uint8_t) (r->semente >> (8 * i));
+    for (int i = 0; i < 4; i++) cabecalho[16 + i] = (uint8_t) ((uint32_t) r->quantidade >> (8 * i));
+    FILE *arquivo = fopen(caminho, "wb");
+    if (!arquivo) return 0;
+    int ok = fwrite(cabecalho, 1, sizeof(cabecalho), arquivo) == sizeof(cabecalho) &&
+             fwrite(r->entradas, 1, r->quantidade, arquivo) == r->quantidade;
+    return fclose(arquivo) == 0 && ok;
+}
+
+/**
+ * @brief Lê um replay gravado por salvarReplay.
+ * @return 1 se deu certo, 0 se o arquivo não existe, está truncado ou não é um replay.
+ */
+int carregarReplay(Replay *r, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "rb");
+    if (!arquivo) return 0;
+    uint8_t cabecalho[REPLAY_CABECALHO];
+    if (fread(cabecalho, 1, sizeof(cabecalho), arquivo) != sizeof(cabecalho) ||
+        memcmp(cabecalho, "TTRP", 4) != 0 || cabecalho[4] != REPLAY_VERSAO) {
+        fclose(arquivo);
+        return 0;
+    }
+    uint64_t semente = 0;
+    uint32_t quantidade = 0;
+    for (int i = 0; i < 8; i++) semente |= (uint64_t) cabecalho[8 + i] << (8 * i);
+    for (int i = 0; i < 4; i++) quantidade |= (uint32_t) cabecalho[16 + i] << (8 * i);
+    inicializarReplay(r, semente, cabecalho[5] == GERADOR_ALEATORIO ? GERADOR_ALEATORIO : GERADOR_SACO);
+    r->entradas = (uint8_t *) malloc(quantidade ? quantidade : 1);
+    if (!r->entradas || fread(r->entradas, 1, quantidade, arquivo) != quantidade) {
+        fclose(arquivo);
+        liberarReplay(r);
+        return 0;
+    }
+    r->quantidade = r->capacidade = quantidade;
+    fclose(arquivo);
+    return 1;
+}
+
+/**
+ * @brief Aplica uma entrada gravada à sessão, com o mesmo efeito que ela teve no
+ * menu, mas sem escrever nada na tela.
+ */
+static inline void aplicarEntrada(Sessao *s, uint8_t entrada) {
+    int acao = entrada >> 6;
+    if (acao == REPLAY_INSERIR) {
+        enfileirar(&s->fila, gerarPeca(&s->gerador));
+        return;
+    }
+    Peca peca;
+    if (!desenfileirar(&s->fila, &peca) || acao != REPLAY_JOGAR) return;
+    int resultado = passoTabuleiro(&s->tabuleiro, indiceDoTipo(peca.nome), (entrada >> 4) & 3, entrada & 15);
+    encerrarPartidaSeAcabou(s, resultado);
+}
+
+/**
+ * @brief Reproduz o replay do começo ao fim na velocidade máxima, sem tela.
+ */
+void reproduzirReplay(const Replay *r, ResumoSessao *resumo) {
+    Sessao s;
+    iniciarSessao(&s, r->semente, r->modo);
+    for (size_t i = 0; i < r->quantidade; i++) aplicarEntrada(&s, r->entradas[i]);
+    resumirSessao(&s, resumo);
+}
+
+// --- IA (busca de jogadas) ---
+
+static inline int contarBits(uint32_t x) {
+    int n = 0;
+    for (; x; x &= x - 1) n++;
+    return n;
+}
+
+/**
+ * @brief Nota heurística do tabuleiro (quanto maior, melhor).
+ * Percorre as linhas de cima para baixo guardando o OR das linhas acima: um
+ * bloco aparece pela primeira vez no topo da coluna, e cada casa vazia embaixo
+ * de algo já visto é um buraco.
+ */
+double avaliarTabuleiro(const Tabuleiro *t) {
+    int alturas[LARGURA_TABULEIRO] = {0};
+    uint32_t acima = 0;
+    int buracos = 0;
+    for (int y = t->altura - 1; y >= 0; y--) {
+        uint32_t linha = t->linhas[y];
+        buracos += contarBits(~linha & acima & LINHA_CHEIA);
+        for (uint32_t novas = linha & ~acima; novas; novas &= novas - 1) {
+            int x = 0;
+            while (!((novas >> x) & 1)) x++;
+            alturas[x] = y + 1;
+        }
+        acima |= linha;
+    }
+    int soma = alturas[0], irregularidade = 0;
+    for (int x = 1; x < LARGURA_TABULEIRO; x++) {
+        soma += alturas[x];
+        irregularidade += abs(alturas[x] - alturas[x - 1]);
+    }
+    return PESO_ALTURA * soma + PESO_BURACOS * buracos + PESO_IRREGULARIDADE * irregularidade;
+}
+
+/**
+ * @brief Lista todas as rotações e colunas possíveis para uma peça.
+ * @return Quantas jogadas foram escritas em 'jogadas' (até MAX_JOGADAS).
+ */
+int listarJogadas(int tipo, Jogada *jogadas) {
+    int n = 0;
+    for (int r = 0; r < num_rotacoes[tipo]; r++) {
+        for (int x = 0; x + formas[tipo][r].largura <= LARGURA_TABULEIRO; x++) {
+            jogadas[n].rotacao = r;
+            jogadas[n].coluna = x;
+            n++;
+        }
+    }
+    return n;
+}
+
+int inicializarTabelaTransposicao(TabelaTransposicao *tt, size_t capacidade) {
+    capacidade = potenciaDe2(capacidade);
+    tt->entradas = new (std::nothrow) EntradaTransposicao[capacidade];
+    if (!tt->entradas) return 0;
+    tt->mascara = capacidade - 1;
+    for (size_t i = 0; i < capacidade; i++) {
+        tt->entradas[i].chave_xor_valor.store(0, std::memory_order_relaxed);
+        tt->entradas[i].valor.store(0, std::memory_order_relaxed);
+    }
+    return 1;
+}
+
+void liberarTabelaTransposicao(TabelaTransposicao *tt) {
+    delete[] tt->entradas;
+    tt->entradas = NULL;
+}
+
+/**
+ * @brief Chave de 64 bits do tabuleiro mais as peças que ainda faltam jogar
+ * (o mesmo tabuleiro vale coisas diferentes conforme as próximas peças).
+ */
+static uint64_t chaveDaPosicao(const Tabuleiro *t, const int *tipos, int restantes) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ (uint64_t) restantes;
+    for (int i = 0; i < restantes; i++) h = (h ^ (uint64_t) tipos[i]) * 0x100000001B3ULL;
+    for (int y = 0; y < t->altura; y += 4) {
+        uint64_t bloco;
+        memcpy(&bloco, &t->linhas[y], sizeof(bloco));
+        h = (h ^ bloco) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+    }
+    return h | 1; // 0 marca posição vazia
+}
+
+static int consultarTransposicao(TabelaTransposicao *tt, uint64_t chave, double *valor) {
+    EntradaTransposicao *e = &tt->entradas[chave & tt->mascara];
+    uint64_t bits = e->valor.load(std::memory_order_relaxed);
+    if ((e->chave_xor_valor.load(std::memory_order_relaxed) ^ bits) != chave) return 0;
+    memcpy(valor, &bits, sizeof(bits));
+    return 1;
+}
+
+static void gravarTransposicao(TabelaTransposicao *tt, uint64_t chave, double valor) {
+    EntradaTransposicao *e = &tt->entradas[chave & tt->mascara];
+    uint64_t bits;
+    memcpy(&bits, &valor, sizeof(bits));
+    e->chave_xor_valor.store(chave ^ bits, std::memory_order_relaxed);
+    e->valor.store(bits, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Melhor valor alcançável jogando as 'restantes' peças de 'tipos' a
+ * partir de 't': linhas eliminadas no caminho mais a nota do tabuleiro final.
+ * @param nos Contador de tabuleiros gerados (um por thread).
+ */
+static double melhorValor(const Tabuleiro *t, const int *tipos, int restantes,
+                          TabelaTransposicao *tt, long long *nos) {
+    if (restantes == 0) return avaliarTabuleiro(t);
+    uint64_t chave = chaveDaPosicao(t, tipos, restantes);
+    double melhor;
+    if (consultarTransposicao(tt, chave, &melhor)) return melhor;
+
+    Jogada jogadas[MAX_JOGADAS];
+    int n = listarJogadas(tipos[0], jogadas);
+    melhor = VALOR_PERDIDO;
+    for (int i = 0; i < n; i++) {
+        Tabuleiro filho = *t;
+        int linhas = passoTabuleiro(&filho, tipos[0], jogadas[i].rotacao, jogadas[i].coluna);
+        (*nos)++;
+        if (linhas < 0) continue;
+        double valor = PESO_LINHAS * linhas + melhorValor(&filho, tipos + 1, restantes - 1, tt, nos);
+        if (valor > melhor) melhor = valor;
+    }
+    gravarTransposicao(tt, chave, melhor);
+    return melhor;
+}
+
+/**
+ * @brief Deque de tarefas de uma thread: a dona tira do fim, as outras roubam
+ * do começo quando a sua acaba.
+ */
+struct FilaTrabalho {
+    std::mutex trava;
+    std::deque<int> tarefas;
+};
+
+/**
+ * @brief Escolhe a jogada para tipos[0] olhando também as peças tipos[1..n-1].
+ * Cada tarefa é um par (jogada da peça atual, jogada da seguinte); as tarefas
+ * são repartidas em blocos entre as threads, que roubam umas das outras quando
+ * esvaziam a própria fila. A tabela de transposição é compartilhada. O
+ * resultado não depende do número de threads.
+ * @param nos Recebe quantos tabuleiros foram gerados.
+ * @return A jogada escolhida; rotacao = -1 se nenhuma couber.
+ */
+Jogada escolherJogada(const Tabuleiro *t, const int *tipos, int n, int threads,
+                      TabelaTransposicao *tt, long long *nos) {
+    Jogada primeiras[MAX_JOGADAS], segundas[MAX_JOGADAS];
+    int n1 = listarJogadas(tipos[0], primeiras);
+    int n2 = n > 1 ? listarJogadas(tipos[1], segundas) : 1;
+    Tabuleiro depois[MAX_JOGADAS];
+    int linhas1[MAX_JOGADAS];
+    for (int i = 0; i < n1; i++) {
+        depois[i] = *t;
+        linhas1[i] = passoTabuleiro(&depois[i], tipos[0], primeiras[i].rotacao, primeiras[i].coluna);
+    }
+
+    int total = n1 * n2;
+    std::vector<double> valores(total, VALOR_PERDIDO);
+    std::vector<long long> nos_por_thread(threads, 0);
+    FilaTrabalho *filas = new FilaTrabalho[threads];
+    for (int tarefa = 0; tarefa < total; tarefa++) {
+        filas[(long long) tarefa * threads / total].tarefas.push_back(tarefa);
+    }
+
+    auto trabalhar = [&](int id) {
+        long long meus_nos = 0;
+        for (;;) {
+            int tarefa = -1;
+            {
+                std::lock_guard<std::mutex> guarda(filas[id].trava);
+                if (!filas[id].tarefas.empty()) {
+                    tarefa = filas[id].tarefas.back();
+                    filas[id].tarefas.pop_back();
+                }
+            }
+            for (int k = 1; tarefa < 0 && k < threads; k++) {
+                FilaTrabalho &vitima = filas[(id + k) % threads];
+                std::lock_guard<std::mutex> guarda(vitima.trava);
+                if (!vitima.tarefas.empty()) {
+                    tarefa = vitima.tarefas.front();
+                    vitima.tarefas.pop_front();
+                }
+            }
+            if (tarefa < 0) break; // as tarefas não geram outras: acabou
+            int i = tarefa / n2, j = tarefa % n2;
+            if (linhas1[i] < 0) continue;
+            if (n == 1) {
+                valores[tarefa] = avaliarTabuleiro(&depois[i]);
+                continue;
+            }
+            Tabuleiro filho = depois[i];
+            int linhas2 = passoTabuleiro(&filho, tipos[1], segundas[j].rotacao, segundas[j].coluna);
+            meus_nos++;
+            if (linhas2 < 0) continue;
+            valores[tarefa] = PESO_LINHAS * linhas2 + melhorValor(&filho, tipos + 2, n - 2, tt, &meus_nos);
+        }
+        nos_por_thread[id] = meus_nos;
+    };
+    std::vector<std::thread> trabalhadores;
+    for (int id = 1; id < threads; id++) trabalhadores.emplace_back(trabalhar, id);
+    trabalhar(0);
+    for (size_t k = 0; k < trabalhadores.size(); k++) trabalhadores[k].join();
+    delete[] filas;
+
+    Jogada escolhida = {-1, 0};
+    double melhor = VALOR_PERDIDO;
+    *nos = n1;
+    for (int id = 0; id < threads; id++) *nos += nos_por_thread[id];
+    for (int i = 0; i < n1; i++) {
+        if (linhas1[i] < 0) continue;
+        double valor_i = VALOR_PERDIDO;
+        for (int j = 0; j < n2; j++) {
+            if (valores[i * n2 + j] > valor_i) valor_i = valores[i * n2 + j];
+        }
+        valor_i += PESO_LINHAS * linhas1[i];
+        if (escolhida.rotacao < 0 || valor_i > melhor) {
+            melhor = valor_i;
+            escolhida = primeiras[i];
+        }
+    }
+    return escolhida;
+}
+
+// --- Funções de Interface com o Usuário ---
+
+/**
+ * @brief Exibe o estado atual da fila de peças na tela.
+ * A exibição percorre a fila de forma circular, do início até o fim.
+ * @param tela Quadro onde o texto é montado.
+ * @param f Ponteiro para a fila a ser exibida.
+ */
+void exibirFila(Tela *tela, const Fila *f) {
+    telaEscrever(tela, "\nFila de pecas: ");
+    if (f->quantidade == 0) {
+        telaEscrever(tela, "[VAZIA]");
+    } else {
+        int i;
+        int indice_atual;
+        for (i = 0; i < f->quantidade; i++) {
+            // Calcula o índice real no array circular
+            indice_atual = (f->inicio + i) % TAMANHO_FILA;
+            telaEscrever(tela, "[%c %d] ", f->itens[indice_atual].nome, f->itens[indice_atual].id);
+        }
+    }
+    telaEscrever(tela, "\n");
+}
+
+/**
+ * @brief Desenha o tabuleiro, da linha de cima para a de baixo.
+ * Cada linha é montada inteira num vetor e acrescentada de uma vez.
+ * @param tela Quadro onde o texto é montado.
+ * @param t Ponteiro para o tabuleiro a ser exibido.
+ */
+void exibirTabuleiro(Tela *tela, const Tabuleiro *t) {
+    char linha[LARGURA_TABULEIRO + 3];
+    linha[0] = '|';
+    linha[LARGURA_TABULEIRO + 1] = '|';
+    linha[LARGURA_TABULEIRO + 2] = '\n';
+    telaEscrever(tela, "\n");
+    for (int y = ALTURA_TABULEIRO - 1; y >= 0; y--) {
+        for (int x = 0; x < LARGURA_TABULEIRO; x++) {
+            linha[x + 1] = (t->linhas[y] >> x) & 1 ? '#' : '.';
+        }
+        telaEscreverBytes(tela, linha, sizeof(linha));
+    }
+    for (int x = 1; x <= LARGURA_TABULEIRO; x++) linha[x] = '-';
+    linha[0] = linha[LARGURA_TABULEIRO + 1] = '+';
+    telaEscreverBytes(tela, linha, LARGURA_TABULEIRO + 2);
+    telaEscrever(tela, "  pecas: %lld  linhas: %lld\n", t->pecas_colocadas, t->linhas_eliminadas);
+}
+
+/**
+ * @brief Mostra o resultado de passoTabuleiro; no fim de jogo, mostra o
+ * tabuleiro final e recomeça a partida.
+ */
+void mostrarResultadoJogada(Tela *tela, Sessao *s, int resultado) {
+    if (resultado > 0) telaEscrever(tela, "=> %d linha(s) eliminada(s)!\n", resultado);
+    if (resultado == FIM_DE_JOGO) {
+        exibirTabuleiro(tela, &s->tabuleiro);
+        telaEscrever(tela, "\nA peca nao cabe mais: fim de partida. Tabuleiro reiniciado.\n");
+    }
+    encerrarPartidaSeAcabou(s, resultado);
+}
+
+/**
+ * @brief Exibe o menu de opções para o jogador.
+ */
+void exibirMenu(Tela *tela) {
+    telaEscrever(tela, "\nOpcoes de acao:\n"
+                       "1 - Jogar peca (dequeue)\n"
+                       "2 - Inserir nova peca (enqueue)\n"
+                       "3 - Deixar a IA jogar a peca da frente\n"
+                       "0 - Sair\n"
+                       "Escolha sua acao: ");
+}
+
+/**
+ * @brief Monta o quadro de uma rodada: tabuleiro, fila, as mensagens da ação
+ * anterior e o menu. O tabuleiro vem primeiro para ficar sempre nas mesmas
+ * linhas da tela, e assim só as casas que mudaram precisam ser redesenhadas.
+ */
+void montarQuadro(Tela *tela, const Sessao *s, const Tela *mensagens) {
+    exibirTabuleiro(tela, &s->tabuleiro);
+    exibirFila(tela, &s->fila);
+    telaEscreverBytes(tela, mensagens->quadro, mensagens->tamanho);
+    exibirMenu(tela);
+}
+
+
+// --- Benchmarks ---
+
+static long long agoraNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#define AMOSTRA_LATENCIA 64 // mede a latência de uma peça a cada 64
+
+/**
+ * @brief Resultado de uma rodada do benchmark das filas.
+ */
+typedef struct {
+    double ops_por_segundo;
+    long long p50_ns;
+    long long p99_ns;
+} ResultadoFila;
+
+/**
+ * @brief Passa 'total' peças de 'produtores' threads para um consumidor.
+ * Com 'spsc' = 1 usa a FilaSPSC (e um produtor só); senão a FilaMPMC. A cada
+ * AMOSTRA_LATENCIA peças o produtor anota a hora de envio e o consumidor mede
+ * quanto tempo a peça levou para chegar até ele.
+ */
+static ResultadoFila medirFila(int spsc, int produtores, int total, size_t capacidade) {
+    FilaSPSC fila_spsc;
+    FilaMPMC fila_mpmc;
+    if (spsc) inicializarFilaSPSC(&fila_spsc, capacidade);
+    else inicializarFilaMPMC(&fila_mpmc, capacidade);
+    int por_produtor = total / produtores;
+    total = por_produtor * produtores;
+    std::vector<long long> enviado(total);
+    std::vector<long long> latencias;
+    latencias.reserve(total / AMOSTRA_LATENCIA + 1);
+
+    long long inicio = agoraNs();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < produtores; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < por_produtor; i++) {
+                Peca p;
+                p.nome = 'I';
+                p.id = t * por_produtor + i;
+                if (p.id % AMOSTRA_LATENCIA == 0) enviado[p.id] = agoraNs();
+                while (!(spsc ? enfileirarSPSC(&fila_spsc, p) : enfileirarMPMC(&fila_mpmc, p))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int recebidas = 0; recebidas < total;) {
+        Peca p;
+        if (spsc ? desenfileirarSPSC(&fila_spsc, &p) : desenfileirarMPMC(&fila_mpmc, &p)) {
+            if (p.id % AMOSTRA_LATENCIA == 0) latencias.push_back(agoraNs() - enviado[p.id]);
+            recebidas++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    long long fim = agoraNs();
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+    if (spsc) liberarFilaSPSC(&fila_spsc);
+    else liberarFilaMPMC(&fila_mpmc);
+
+    ResultadoFila r;
+    r.ops_por_segundo = total / ((fim - inicio) / 1e9);
+    std::sort(latencias.begin(), latencias.end());
+    r.p50_ns = latencias.empty() ? 0 : latencias[latencias.size() / 2];
+    r.p99_ns = latencias.empty() ? 0 : latencias[latencias.size() * 99 / 100];
+    return r;
+}
+
+/**
+ * @brief Vazão e latência de entrega (p50/p99) das filas sem travas, de 1 até
+ * 'max_produtores' produtores e um consumidor (o laço do jogo).
+ */
+void benchmarkFila(int max_produtores, int total) {
+    const size_t capacidade = 1024;
+    printf("%d pecas por rodada, fila de %zu posicoes, 1 consumidor\n", total, capacidade);
+    printf("%-6s %11s %14s %10s %10s\n", "fila", "produtores", "ops/s", "p50(ns)", "p99(ns)");
+    ResultadoFila r = medirFila(1, 1, total, capacidade);
+    printf("%-6s %11d %14.0f %10lld %10lld\n", "SPSC", 1, r.ops_por_segundo, r.p50_ns, r.p99_ns);
+    for (int produtores = 1; produtores <= max_produtores; produtores++) {
+        r = medirFila(0, produtores, total, capacidade);
+        printf("%-6s %11d %14.0f %10lld %10lld\n", "MPMC", produtores, r.ops_por_segundo, r.p50_ns, r.p99_ns);
+    }
+}
+
+/**
+ * @brief Enche e esvazia a Fila 'ciclos' vezes, peça a peça e em lote, começando
+ * cada ciclo numa posição diferente para que os lotes deem a volta no vetor.
+ */
+void benchmarkLote(int ciclos) {
+    Fila f;
+    Peca pecas[TAMANHO_FILA], saida[TAMANHO_FILA];
+    for (int i = 0; i < TAMANHO_FILA; i++) {
+        pecas[i].nome = 'T';
+        pecas[i].id = i;
+    }
+    long long soma = 0;
+    for (int modo = 0; modo < 2; modo++) {
+        inicializarFila(&f);
+        long long inicio = agoraNs();
+        for (int c = 0; c < ciclos; c++) {
+            enfileirar(&f, pecas[0]); // desloca o início da fila a cada ciclo
+            if (modo == 0) {
+                for (int i = 1; i < TAMANHO_FILA; i++) enfileirar(&f, pecas[i]);
+                for (int i = 0; i < TAMANHO_FILA; i++) desenfileirar(&f, &saida[i]);
+            } else {
+                enfileirarLote(&f, pecas + 1, TAMANHO_FILA - 1);
+                desenfileirarLote(&f, saida, TAMANHO_FILA);
+            }
+            soma += saida[TAMANHO_FILA - 1].id;
+        }
+        long long fim = agoraNs();
+        printf("%-12s %8.2f ns por ciclo (encher e esvaziar %d pecas)\n",
+               modo == 0 ? "peca a peca" : "em lote", (double) (fim - inicio) / ciclos, TAMANHO_FILA);
+    }
+    if (soma != 2LL * ciclos * (TAMANHO_FILA - 1)) printf("ERRO: pecas fora de ordem\n");
+}
+
+/**
+ * @brief Cada thread gera 'por_thread' peças com o seu próprio gerador.
+ * modo -1 usa rand() % 7, que em muitas libc passa por uma trava global.
+ * @return Peças por segundo somando todas as threads.
+ */
+static double medirGerador(int modo, int threads, int por_thread, long long *contagem) {
+    std::vector<std::thread> trabalhadores;
+    std::vector<long long> contagens((size_t) threads * NUM_TIPOS_PECA, 0);
+    long long inicio = agoraNs();
+    for (int t = 0; t < threads; t++) {
+        trabalhadores.emplace_back([&, t]() {
+            long long *minha = &contagens[(size_t) t * NUM_TIPOS_PECA];
+            long long local[NUM_TIPOS_PECA] = {0};
+            if (modo < 0) {
+                for (int i = 0; i < por_thread; i++) local[rand() % NUM_TIPOS_PECA]++;
+            } else {
+                Gerador g;
+                semearGerador(&g, (uint64_t) t + 1, modo);
+                for (int i = 0; i < por_thread; i++) {
+                    char nome = gerarPeca(&g).nome;
+                    local[(const char *) memchr(TIPOS_DE_PECA, nome, NUM_TIPOS_PECA) - TIPOS_DE_PECA]++;
+                }
+            }
+            memcpy(minha, local, sizeof(local));
+        });
+    }
+    for (size_t t = 0; t < trabalhadores.size(); t++) trabalhadores[t].join();
+    long long fim = agoraNs();
+    for (int k = 0; k < NUM_TIPOS_PECA; k++) {
+        contagem[k] = 0;
+        for (int t = 0; t < threads; t++) contagem[k] += contagens[(size_t) t * NUM_TIPOS_PECA + k];
+    }
+    return (double) threads * por_thread / ((fim - inicio) / 1e9);
+}
+
+/**
+ * @brief Peças por segundo de 1 até 'max_threads' geradores independentes, para
+ * rand() % 7 e para os dois modos do Gerador, e quantas vezes saiu cada peça.
+ */
+void benchmarkGerador(int max_threads, int por_thread) {
+    const char *nomes[] = {"rand()%7", "aleatorio", "saco"};
+    printf("%d pecas por thread\n", por_thread);
+    printf("%-10s %8s %14s %14s   ", "gerador", "threads", "pecas/s", "por thread");
+    for (int k = 0; k < NUM_TIPOS_PECA; k++) printf("%9c", TIPOS_DE_PECA[k]);
+    printf("\n");
+    for (int modo = -1; modo <= GERADOR_SACO; modo++) {
+        for (int threads = 1; threads <= max_threads; threads++) {
+            long long contagem[NUM_TIPOS_PECA];
+            double vazao = medirGerador(modo, threads, por_thread, contagem);
+            printf("%-10s %8d %14.0f %14.0f   ", nomes[modo + 1], threads, vazao, vazao / threads);
+            for (int k = 0; k < NUM_TIPOS_PECA; k++) {
+                printf("%8.3f%%", 100.0 * contagem[k] / ((double) threads * por_thread));
+            }
+            printf("\n");
+        }
+    }
+}
+
+/**
+ * @brief Joga 'total' peças do saco de 7 em posições sorteadas, recomeçando o
+ * tabuleiro a cada fim de jogo, e mede quantas jogadas por segundo passoTabuleiro
+ * consegue fazer.
+ */
+void benchmarkTabuleiro(long long total) {
+    Gerador g;
+    semearGerador(&g, 1, GERADOR_SACO);
+    Tabuleiro t;
+    inicializarTabuleiro(&t);
+    long long partidas = 1, linhas = 0;
+    long long inicio = agoraNs();
+    for (long long i = 0; i < total; i++) {
+        int tipo = indiceDoTipo(gerarPeca(&g).nome);
+        int rotacao = (int) sortearAte(&g, (uint32_t) num_rotacoes[tipo]);
+        int coluna = (int) sortearAte(&g, (uint32_t) (LARGURA_TABULEIRO - formas[tipo][rotacao].largura + 1));
+        if (passoTabuleiro(&t, tipo, rotacao, coluna) == FIM_DE_JOGO) {
+            linhas += t.linhas_eliminadas;
+            inicializarTabuleiro(&t);
+            partidas++;
+            passoTabuleiro(&t, tipo, rotacao, coluna);
+        }
+    }
+    long long fim = agoraNs();
+    linhas += t.linhas_eliminadas;
+#ifdef __SSE2__
+    const char *deteccao = "SSE2";
+#else
+    const char *deteccao = "escalar";
+#endif
+    printf("%lld jogadas em %.3f s: %.0f jogadas/s (deteccao de linhas %s)\n",
+           total, (fim - inicio) / 1e9, total / ((fim - inicio) / 1e9), deteccao);
+    printf("%lld partidas, %lld linhas eliminadas\n", partidas, linhas);
+}
+
+/**
+ * @brief Bot jogando sozinho: a cada peça chama escolherJogada com a prévia da
+ * fila, como na opção 3 do menu, até 'total' peças ou o fim do jogo.
+ */
+void partidaIA(long long total, int previa, int threads) {
+    Gerador g;
+    semearGerador(&g, 1, GERADOR_SACO);
+    Tabuleiro t;
+    inicializarTabuleiro(&t);
+    TabelaTransposicao tt;
+    if (!inicializarTabelaTransposicao(&tt, (size_t) 1 << 20)) return;
+    Fila fila;
+    inicializarFila(&fila);
+    long long nos_total = 0;
+    long long inicio = agoraNs();
+    for (long long i = 0; i < total && !t.fim_de_jogo; i++) {
+        while (fila.quantidade < previa + 1) enfileirar(&fila, gerarPeca(&g));
+        Peca vistas[TAMANHO_FILA];
+        int tipos[TAMANHO_FILA];
+        int n = espiarFila(&fila, vistas, previa + 1);
+        for (int k = 0; k < n; k++) tipos[k] = indiceDoTipo(vistas[k].nome);
+        long long nos;
+        Jogada j = escolherJogada(&t, tipos, n, threads, &tt, &nos);
+        nos_total += nos;
+        Peca atual;
+        desenfileirar(&fila, &atual);
+        if (j.rotacao < 0) break;
+        passoTabuleiro(&t, tipos[0], j.rotacao, j.coluna);
+    }
+    long long fim = agoraNs();
+    liberarTabelaTransposicao(&tt);
+    Tela tela;
+    telaInicializar(&tela, 1, TELA_FLUXO);
+    exibirTabuleiro(&tela, &t);
+    telaMostrar(&tela);
+    telaLiberar(&tela);
+    printf("%s apos %lld pecas, %lld linhas; %.0f pecas/s, %.0f nos/s (previa %d, %d threads)\n",
+           t.fim_de_jogo ? "Fim de jogo" : "Parou", t.pecas_colocadas, t.linhas_eliminadas,
+           t.pecas_colocadas / ((fim - inicio) / 1e9), nos_total / ((fim - inicio) / 1e9), previa, threads);
+}
+
+/**
+ * @brief Nós por segundo da busca de 1 até 'max_threads' threads, sempre nas
+ * mesmas 'posicoes' (tabuleiros tirados de uma partida do bot sem prévia).
+ * Cada rodada começa com a tabela vazia e confere se escolheu as mesmas jogadas
+ * que a rodada com uma thread.
+ */
+void benchmarkIA(int previa, int max_threads, int posicoes) {
+    std::vector<Tabuleiro> tabuleiros;
+    std::vector<int> sequencias;
+    Gerador g;
+    semearGerador(&g, 7, GERADOR_SACO);
+    Tabuleiro t;
+    inicializarTabuleiro(&t);
+    TabelaTransposicao tt;
+    if (!inicializarTabelaTransposicao(&tt, (size_t) 1 << 22)) return;
+    int tipos[TAMANHO_FILA];
+    for (int k = 0; k <= previa; k++) tipos[k] = indiceDoTipo(gerarPeca(&g).nome);
+    for (int p = 0; p < posicoes * 8; p++) {
+        if (p % 8 == 0) {
+            tabuleiros.push_back(t);
+            sequencias.insert(sequencias.end(), tipos, tipos + previa + 1);
+        }
+        long long nos;
+        Jogada j = escolherJogada(&t, tipos, 1, 1, &tt, &nos);
+        if (j.rotacao < 0 || passoTabuleiro(&t, tipos[0], j.rotacao, j.coluna) < 0) inicializarTabuleiro(&t);
+        memmove(tipos, tipos + 1, previa * sizeof(int));
+        tipos[previa] = indiceDoTipo(gerarPeca(&g).nome);
+    }
+
+    printf("%d posicoes, peca atual + %d de previa\n", posicoes, previa);
+    printf("%8s %14s %10s %10s\n", "threads", "nos/s", "tempo(s)", "iguais");
+    std::vector<Jogada> referencia;
+    for (int threads = 1; threads <= max_threads; threads++) {
+        liberarTabelaTransposicao(&tt);
+        inicializarTabelaTransposicao(&tt, (size_t) 1 << 22);
+        long long nos_total = 0;
+        int iguais = 0;
+        long long inicio = agoraNs();
+        for (int p = 0; p < posicoes; p++) {
+            long long nos;
+            Jogada j = escolherJogada(&tabuleiros[p], &sequencias[(size_t) p * (previa + 1)], previa + 1,
+                                      threads, &tt, &nos);
+            nos_total += nos;
+            if (threads == 1) referencia.push_back(j);
+            if (j.rotacao == referencia[p].rotacao && j.coluna == referencia[p].coluna) iguais++;
+        }
+        long long fim = agoraNs();
+        printf("%8d %14.0f %10.3f %7d/%d\n", threads, nos_total / ((fim - inicio) / 1e9),
+               (fim - inicio) / 1e9, iguais, posicoes);
+    }
+    liberarTabelaTransposicao(&tt);
+}
+
+/**
+ * @brief Grava 'quantidade' sessões sintéticas de 'entradas' entradas (jogadas
+ * em posições sorteadas, inserções e descartes), anotando o resumo de cada uma,
+ * e depois reproduz todas em 'threads' threads, conferindo os resumos.
+ */
+void benchmarkReplay(int quantidade, int entradas, int threads) {
+    std::vector<Replay> replays(quantidade);
+    std::vector<ResumoSessao> esperados(quantidade);
+    Gerador sorteio;
+    semearGerador(&sorteio, 99, GERADOR_ALEATORIO);
+    for (int k = 0; k < quantidade; k++) {
+        Replay *r = &replays[k];
+        inicializarReplay(r, proximoAleatorio(&sorteio), k % 2 ? GERADOR_ALEATORIO : GERADOR_SACO);
+        Sessao s;
+        iniciarSessao(&s, r->semente, r->modo);
+        for (int i = 0; i < entradas; i++) {
+            uint32_t dado = sortearAte(&sorteio, 100);
+            int acao = dado < 70 ? REPLAY_JOGAR : dado < 97 ? REPLAY_INSERIR : REPLAY_DESCARTAR;
+            int rotacao = (int) sortearAte(&sorteio, 4), coluna = (int) sortearAte(&sorteio, LARGURA_TABULEIRO);
+            if (!gravarEntrada(r, acao, rotacao, coluna)) return;
+            aplicarEntrada(&s, r->entradas[r->quantidade - 1]);
+        }
+        resumirSessao(&s, &esperados[k]);
+    }
+
+    std::atomic<int> proximo(0), divergencias(0);
+    long long inicio = agoraNs();
+    std::vector<std::thread> trabalhadores;
+    for (int t = 0; t < threads; t++) {
+        trabalhadores.emplace_back([&]() {
+            for (int k; (k = proximo.fetch_add(1, std::memory_order_relaxed)) < quantidade;) {
+                ResumoSessao resumo;
+                reproduzirReplay(&replays[k], &resumo);
+                if (resumo.assinatura != esperados[k].assinatura || resumo.pecas != esperados[k].pecas) {
+                    divergencias.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (size_t t = 0; t < trabalhadores.size(); t++) trabalhadores[t].join();
+    long long fim = agoraNs();
+    double segundos = (fim - inicio) / 1e9;
+    printf("%d replays de %d entradas em %.3f s com %d thread(s)\n", quantidade, entradas, segundos, threads);
+    printf("%.0f replays/s, %.0f entradas/s, %d divergencia(s)\n", quantidade / segundos,
+           (double) quantidade * entradas / segundos, divergencias.load());
+    for (int k = 0; k < quantidade; k++) liberarReplay(&replays[k]);
+}
+
+/**
+ * @brief Custo de desenhar 'quadros' rodadas de uma partida com jogadas
+ * sorteadas, escrevendo em /dev/null. Compara uma escrita por linha (o que o
+ * printf faz num terminal, onde a saída tem buffer de linha) com a Tela nos
+ * modos fluxo (um write por quadro) e redesenho (um write só com as linhas que mudaram).
+ */
+void benchmarkTela(int quadros) {
+#if defined(_WIN32)
+    const char *nulo = "NUL";
+#else
+    const char *nulo = "/dev/null";
+#endif
+    FILE *destino = fopen(nulo, "wb");
+    if (!destino) return;
+    int descritor = fileno(destino);
+    const char *nomes[] = {"por linha", "fluxo", "redesenho"};
+    printf("%d quadros de uma partida com jogadas sorteadas\n", quadros);
+    printf("%-10s %16s %16s %14s\n", "saida", "writes/quadro", "bytes/quadro", "ns/quadro");
+    for (int modo = 0; modo < 3; modo++) {
+        Sessao s;
+        iniciarSessao(&s, 3, GERADOR_SACO);
+        Gerador sorteio;
+        semearGerador(&sorteio, 4, GERADOR_ALEATORIO);
+        Tela tela;
+        telaInicializar(&tela, descritor, modo == 2 ? TELA_REDESENHO : TELA_FLUXO);
+        Tela mensagens;
+        telaInicializar(&mensagens, -1, TELA_FLUXO);
+        long long escritas = 0, bytes = 0;
+        long long inicio = agoraNs();
+        for (int q = 0; q < quadros; q++) {
+            telaLimpar(&mensagens);
+            Peca peca;
+            if (!desenfileirar(&s.fila, &peca)) continue;
+            int tipo = indiceDoTipo(peca.nome);
+            int rotacao = (int) sortearAte(&sorteio, (uint32_t) num_rotacoes[tipo]);
+            int coluna = (int) sortearAte(&sorteio, (uint32_t) (LARGURA_TABULEIRO - formas[tipo][rotacao].largura + 1));
+            telaEscrever(&mensagens, "\n=> Peca jogada: [%c %d]\n", peca.nome, peca.id);
+            mostrarResultadoJogada(&mensagens, &s, passoTabuleiro(&s.tabuleiro, tipo, rotacao, coluna));
+            enfileirar(&s.fila, gerarPeca(&s.gerador));
+            telaLimpar(&tela);
+            montarQuadro(&tela, &s, &mensagens);
+            if (modo == 0) {
+                for (size_t i = 0; i < tela.tamanho;) {
+                    const char *quebra = (const char *) memchr(tela.quadro + i, '\n', tela.tamanho - i);
+                    size_t n = quebra ? (size_t) (quebra - tela.quadro) + 1 - i : tela.tamanho - i;
+                    telaEnviar(&tela, tela.quadro + i, n);
+                    i += n;
+                }
+            } else {
+                telaMostrar(&tela);
+            }
+        }
+        long long fim = agoraNs();
+        escritas = tela.escritas;
+        bytes = tela.bytes;
+        telaLiberar(&tela);
+        telaLiberar(&mensagens);
+        printf("%-10s %16.2f %16.1f %14.0f\n", nomes[modo], (double) escritas / quadros,
+               (double) bytes / quadros, (double) (fim - inicio) / quadros);
+    }
+    fclose(destino);
+}
+
+
+// --- Função Principal ---
+
+int main(int argc, char *argv[]) {
+    inicializarFormas();
+
+    if (argc > 1 && strcmp(argv[1], "--bench-fila") == 0) {
+        int produtores = argc > 2 ? atoi(argv[2]) : (int) std::thread::hardware_concurrency();
+        benchmarkFila(produtores > 0 ? produtores : 1, argc > 3 ? atoi(argv[3]) : 2000000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-lote") == 0) {
+        benchmarkLote(argc > 2 ? atoi(argv[2]) : 10000000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-tabuleiro") == 0) {
+        benchmarkTabuleiro(argc > 2 ? atoll(argv[2]) : 20000000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--ia") == 0) {
+        int threads = argc > 4 ? atoi(argv[4]) : (int) std::thread::hardware_concurrency();
+        int previa = argc > 3 ? atoi(argv[3]) : PREVIA_PADRAO;
+        if (previa < 0 || previa > PREVIA_MAXIMA) previa = PREVIA_PADRAO;
+        partidaIA(argc > 2 ? atoll(argv[2]) : 1000, previa, threads > 0 ? threads : 1);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-ia") == 0) {
+        int previa = argc > 2 ? atoi(argv[2]) : PREVIA_PADRAO;
+        if (previa < 0 || previa > PREVIA_MAXIMA) previa = PREVIA_PADRAO;
+        int threads = argc > 3 ? atoi(argv[3]) : (int) std::thread::hardware_concurrency();
+        benchmarkIA(previa, threads > 0 ? threads : 1, argc > 4 ? atoi(argv[4]) : 200);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--reproduzir") == 0) {
+        Replay replay;
+        if (!carregarReplay(&replay, argv[2])) {
+            printf("Erro: %s nao e um replay valido.\n", argv[2]);
+            return 1;
+        }
+        ResumoSessao resumo;
+        long long inicio = agoraNs();
+        reproduzirReplay(&replay, &resumo);
+        long long fim = agoraNs();
+        printf("Semente %llu, %zu entradas em %.3f ms\n", (unsigned long long) replay.semente,
+               replay.quantidade, (fim - inicio) / 1e6);
+        printf("%d partida(s), %lld pecas, %lld linhas, assinatura %016llx\n", resumo.partidas,
+               resumo.pecas, resumo.linhas, (unsigned long long) resumo.assinatura);
+        liberarReplay(&replay);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-replay") == 0) {
+        int threads = argc > 4 ? atoi(argv[4]) : (int) std::thread::hardware_concurrency();
+        benchmarkReplay(argc > 2 ? atoi(argv[2]) : 100000, argc > 3 ? atoi(argv[3]) : 500,
+                        threads > 0 ? threads : 1);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-tela") == 0) {
+        benchmarkTela(argc > 2 ? atoi(argv[2]) : 200000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-gerador") == 0) {
+        int threads = argc > 2 ? atoi(argv[2]) : (int) std::thread::hardware_concurrency();
+        benchmarkGerador(threads > 0 ? threads : 1, argc > 3 ? atoi(argv[3]) : 20000000);
+        return 0;
+    }
+
+    // "--gravar arquivo" antes da semente grava as entradas da partida.
+    const char *arquivo_replay = NULL;
+    if (argc > 2 && strcmp(argv[1], "--gravar") == 0) {
+        arquivo_replay = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
+
+    // Prepara a sessão. A semente é mostrada para que a partida possa ser
+    // repetida com "Tetris <semente>".
+    Sessao sessao;
+    uint64_t semente = argc > 1 ? strtoull(argv[1], NULL, 10) : (uint64_t) time(NULL);
+    int modo = argc > 2 && strcmp(argv[2], "aleatorio") == 0 ? GERADOR_ALEATORIO : GERADOR_SACO;
+    iniciarSessao(&sessao, semente, modo);
+
+    Replay replay;
+    TabelaTransposicao transposicao;
+    int threads_ia = (int) std::thread::hardware_concurrency();
+    int opcao;
+
+    inicializarReplay(&replay, semente, modo);
+    if (!inicializarTabelaTransposicao(&transposicao, (size_t) 1 << 20)) {
+        printf("Erro: sem memoria para a IA.\n");
+        return 1;
+    }
+    if (threads_ia < 1) threads_ia = 1;
+
+    // Cada rodada é um quadro (ver montarQuadro), mostrado de uma vez antes de
+    // ler a próxima ação. As mensagens de cada ação são guardadas à parte até
+    // o quadro seguinte.
+    Tela tela, mensagens;
+    telaInicializar(&tela, 1, TELA_AUTOMATICO);
+    telaInicializar(&mensagens, -1, TELA_FLUXO);
+    telaEscrever(&mensagens, "Semente: %llu (%s)\n", (unsigned long long) semente, modo == GERADOR_SACO ? "saco de 7" : "aleatorio");
+
+    // Loop principal do jogo
+    do {
+        telaLimpar(&tela);
+        montarQuadro(&tela, &sessao, &mensagens);
+        telaLimpar(&mensagens);
+        telaMostrar(&tela);
+        scanf("%d", &opcao);
+
+        switch (opcao) {
+            case 1: { // Jogar peça (dequeue)
+                Peca peca_jogada;
+                if (desenfileirar(&sessao.fila, &peca_jogada)) {
+                    int tipo = indiceDoTipo(peca_jogada.nome);
+                    int rotacao = 0, coluna = 0;
+                    telaEscrever(&tela, "Peca [%c %d]. Rotacao (0-%d) e coluna (0-%d): ",
+                                 peca_jogada.nome, peca_jogada.id, num_rotacoes[tipo] - 1, LARGURA_TABULEIRO - 1);
+                    telaMostrar(&tela);
+                    scanf("%d %d", &rotacao, &coluna);
+                    int resultado = passoTabuleiro(&sessao.tabuleiro, tipo, rotacao, coluna);
+                    while (resultado == JOGADA_INVALIDA) {
+                        telaEscrever(&tela, "\nPosicao invalida. Rotacao (0-%d) e coluna: ", num_rotacoes[tipo] - 1);
+                        telaMostrar(&tela);
+                        if (scanf("%d %d", &rotacao, &coluna) != 2) break;
+                        resultado = passoTabuleiro(&sessao.tabuleiro, tipo, rotacao, coluna);
+                    }
+                    if (resultado == JOGADA_INVALIDA) gravarEntrada(&replay, REPLAY_DESCARTAR, 0, 0);
+                    else gravarEntrada(&replay, REPLAY_JOGAR, rotacao, coluna);
+                    telaEscrever(&mensagens, "\n=> Peca jogada: [%c %d]\n", peca_jogada.nome, peca_jogada.id);
+                    mostrarResultadoJogada(&mensagens, &sessao, resultado);
+                } else {
+                    telaEscrever(&mensagens, "\nAVISO: A fila de pecas esta vazia! Nao ha pecas para jogar.\n");
+                }
+                break;
+            }
+            case 3: { // IA joga a peça da frente, olhando as seguintes
+                Peca vistas[TAMANHO_FILA];
+                int tipos[TAMANHO_FILA];
+                int n = espiarFila(&sessao.fila, vistas, PREVIA_PADRAO + 1);
+                if (n == 0) {
+                    telaEscrever(&mensagens, "\nAVISO: A fila de pecas esta vazia! Nao ha pecas para jogar.\n");
+                    break;
+                }
+                for (int k = 0; k < n; k++) tipos[k] = indiceDoTipo(vistas[k].nome);
+                long long nos;
+                Jogada j = escolherJogada(&sessao.tabuleiro, tipos, n, threads_ia, &transposicao, &nos);
+                if (j.rotacao < 0) j.rotacao = j.coluna = 0; // nada cabe: a jogada só encerra a partida
+                Peca peca_jogada = vistas[0];
+                desenfileirar(&sessao.fila, &peca_jogada);
+                int resultado = passoTabuleiro(&sessao.tabuleiro, tipos[0], j.rotacao, j.coluna);
+                gravarEntrada(&replay, REPLAY_JOGAR, j.rotacao, j.coluna);
+                telaEscrever(&mensagens, "\n=> IA jogou [%c %d] na rotacao %d, coluna %d (%d pecas vistas, %lld tabuleiros)\n",
+                       peca_jogada.nome, peca_jogada.id, j.rotacao, j.coluna, n, nos);
+                mostrarResultadoJogada(&mensagens, &sessao, resultado);
+                break;
+            }
+            case 2: { // Inserir nova peça (enqueue)
+                Peca nova_peca = gerarPeca(&sessao.gerador);
+                gravarEntrada(&replay, REPLAY_INSERIR, 0, 0);
+                if (enfileirar(&sessao.fila, nova_peca)) {
+                     telaEscrever(&mensagens, "\n=> Nova peca inserida: [%c %d]\n", nova_peca.nome, nova_peca.id);
+                } else {
+                    telaEscrever(&mensagens, "\nAVISO: A fila de pecas esta cheia! Nao e possivel inserir.\n");
+                }
+                break;
+            }
+            case 0: { // Sair
+                telaEscrever(&mensagens, "\nFim de jogo. Ate a proxima!\n");
+                break;
+            }
+            default: {
+                telaEscrever(&mensagens, "\nOpcao invalida. Tente novamente.\n");
+            }
+        }
+
+    } while (opcao != 0);
+
+    if (arquivo_replay) {
+        if (salvarReplay(&replay, arquivo_replay)) {
+            telaEscrever(&mensagens, "Replay gravado em %s (%zu entradas).\n", arquivo_replay, replay.quantidade);
+        } else {
+            telaEscrever(&mensagens, "Erro: nao foi possivel gravar %s.\n", arquivo_replay);
+        }
+    }
+    telaLimpar(&tela);
+    telaEscreverBytes(&tela, mensagens.quadro, mensagens.tamanho);
+    telaMostrar(&tela);
+    telaLiberar(&tela);
+    telaLiberar(&mensagens);
+    liberarReplay(&replay);
+    liberarTabelaTransposicao(&transposicao);
+    return 0;
+}